@@ -1,29 +1,37 @@
 // ===================================================================================
-// Basic PRINT Functions                                                      * v1.0 *
+// Basic PRINT Functions                                                      * v1.1 *
 // ===================================================================================
 // 2021 by Stefan Wagner:   https://github.com/wagiminator
 
 #include <stdarg.h>
 #include "print.h"
 
-// For BCD conversion
-const uint16_t DIVIDER[] = {1, 10, 100, 1000, 10000};
+// Decimal conversion: divide value by 10 and return the remainder. AVR has no
+// hardware divider, so a multiply-free shift-and-add reciprocal is used instead of
+// the slow division routines of the compiler library.
+static inline uint8_t _divmod10(uint16_t* value) {
+  uint16_t q, r;
+  q  = (*value >> 1) + (*value >> 2);       // q = value * 0.11b
+  q += q >> 4;                              // q = value * 0.110011b
+  q += q >> 8;                              // q = value * 0.8 (rounded down)
+  q >>= 3;                                  // q = value / 10 (might be 1 too small)
+  r  = *value - (((q << 2) + q) << 1);      // r = value - q * 10
+  if(r > 9) {                               // correct estimation
+    q++;
+    r -= 10;
+  }
+  *value = q;
+  return r;
+}
 
-// Print decimal value (BCD conversion by substraction method)
+// Print decimal value
 void printD(void (*putchar) (char c), uint16_t value) {
-  uint8_t digits   = 5;                     // print 5 digits
-  uint8_t leadflag = 0;                     // flag for leading spaces
-  while(digits--) {                         // for all digits
-    uint8_t digitval = 0;                   // start with digit value 0
-    uint32_t divider = DIVIDER[digits];     // read current divider
-    while(value >= divider) {               // if current divider fits into the value
-      leadflag = 1;                         // end of leading spaces
-      digitval++;                           // increase digit value
-      value -= divider;                     // decrease value by divider
-    }
-    if(!digits)  leadflag++;                // least digit has to be printed
-    if(leadflag) putchar(digitval + '0');   // print the digit
-  }
+  char s[5];                                // digit buffer
+  uint8_t i = 0;
+  do s[i++] = _divmod10(&value) + '0';      // convert digits, least significant first
+  while(value);
+  do putchar(s[--i]);                       // print digits, most significant first
+  while(i);
 }
 
 // Convert 4-bit byte nibble into hex character and print it via putchar
@@ -71,6 +79,52 @@ void printF(void (*putchar) (char c), const char *format, ...) {
   va_end(arg);
 }
 
+// Buffered printf: characters are collected in a buffer, which is either handed to
+// the write function as a block whenever it is full and at the end (printFB), or
+// simply truncated (sprintF). The write function must have consumed (sent or copied)
+// the data when it returns, because the staging buffer is reused afterwards.
+static char PRINT_buffer[PRINT_BUF_SIZE];               // staging buffer for printFB
+static char* PRINT_bufptr;                              // pointer to current buffer
+static uint8_t PRINT_bufsize;                           // size of current buffer
+static uint8_t PRINT_buflen;                            // number of chars in current buffer
+static void (*PRINT_write) (const char* buf, uint8_t len);  // block write function
+
+// Put character into current buffer, hand full buffer over to write function
+static void _bputc(char c) {
+  if(PRINT_buflen >= PRINT_bufsize) {                   // buffer full?
+    if(!PRINT_write) return;                            // -> truncate if no write function
+    PRINT_write(PRINT_bufptr, PRINT_buflen);            // -> hand buffer over as a block
+    PRINT_buflen = 0;                                   // -> start again
+  }
+  PRINT_bufptr[PRINT_buflen++] = c;                     // put char into buffer
+}
+
+void printFB(void (*write) (const char* buf, uint8_t len), const char *format, ...) {
+  va_list arg;
+  PRINT_bufptr  = PRINT_buffer;
+  PRINT_bufsize = PRINT_BUF_SIZE;
+  PRINT_buflen  = 0;
+  PRINT_write   = write;
+  va_start(arg, format);
+  _vfprintf(_bputc, format, arg);
+  va_end(arg);
+  if(PRINT_buflen) write(PRINT_buffer, PRINT_buflen);
+}
+
+uint8_t sprintF(char* buf, uint8_t size, const char *format, ...) {
+  va_list arg;
+  if(!size) return 0;
+  PRINT_bufptr  = buf;
+  PRINT_bufsize = size - 1;                             // leave room for terminator
+  PRINT_buflen  = 0;
+  PRINT_write   = 0;
+  va_start(arg, format);
+  _vfprintf(_bputc, format, arg);
+  va_end(arg);
+  buf[PRINT_buflen] = 0;
+  return PRINT_buflen;
+}
+
 static void _vfprintf(void (*putchar) (char c), const char* str,  va_list arp) {
   int16_t d, r, w, s;
   char *c;
@@ -118,6 +172,7 @@ static void _vfprintf(void (*putchar) (char c), const char* str,  va_list arp) {
 
 void _itoa(void (*putchar) (char c), int16_t val, int8_t rad, int8_t len) {
   char c, sgn = 0, pad = ' ';
+  uint16_t uval;
   char s[10];
   uint8_t i = 0;
 
@@ -133,13 +188,21 @@ void _itoa(void (*putchar) (char c), int16_t val, int8_t rad, int8_t len) {
     pad = '0';
   }
   if(len > 20) return;
+  uval = val;
   do {
-    c = (char)((uint16_t)val % rad);
+    if(rad == 10) c = _divmod10(&uval);
+    else if(rad == 16) {
+      c = uval & 0x0f;
+      uval >>= 4;
+    }
+    else {
+      c = uval & 0x01;
+      uval >>= 1;
+    }
     if (c >= 10) c += ('A' - 10);
     else c += '0';
     s[i++] = c;
-    val = (uint16_t)val / rad;
-  } while(val);
+  } while(uval);
   if((sgn != 0) && (pad != '0')) s[i++] = sgn;
   while(i < len) s[i++] = pad;
   if((sgn != 0) && (pad == '0')) s[i++] = sgn;
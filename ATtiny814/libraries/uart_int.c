@@ -1,14 +1,26 @@
 // ===================================================================================
-// USART0 with RX Interrupt and Ring Buffer for tinyAVR                       * v1.0 *
+// USART0 with RX/TX Interrupts and Ring Buffers for tinyAVR                 * v1.1 *
 // ===================================================================================
 // 2021 by Stefan Wagner:   https://github.com/wagiminator
 
 #include <stdarg.h>
 #include "uart_int.h"
 
-volatile uint8_t UART_buffer[64];     // UART RX ring buffer
-volatile uint8_t UART_rptr = 0;       // UART RX buffer read pointer
-volatile uint8_t UART_wptr = 0;       // UART RX buffer write pointer
+// Check buffer sizes
+#if (UART_RX_BUF_SIZE & (UART_RX_BUF_SIZE - 1)) || (UART_RX_BUF_SIZE > 128)
+  #error UART_RX_BUF_SIZE must be a power of 2 and not greater than 128!
+#endif
+#if (UART_TX_BUF_SIZE & (UART_TX_BUF_SIZE - 1)) || (UART_TX_BUF_SIZE > 128)
+  #error UART_TX_BUF_SIZE must be a power of 2 and not greater than 128!
+#endif
+
+volatile uint8_t UART_buffer[UART_RX_BUF_SIZE];     // UART RX ring buffer
+volatile uint8_t UART_rptr = 0;                     // UART RX buffer read pointer
+volatile uint8_t UART_wptr = 0;                     // UART RX buffer write pointer
+
+volatile uint8_t UART_TX_buffer[UART_TX_BUF_SIZE];  // UART TX ring buffer
+volatile uint8_t UART_TX_rptr = 0;                  // UART TX buffer read pointer
+volatile uint8_t UART_TX_wptr = 0;                  // UART TX buffer write pointer
 
 // Init UART
 void UART_init(void) {
@@ -37,18 +49,45 @@ void UART_init(void) {
 char UART_read(void) {
   while(!UART_available());                     // wait for incoming data byte
   char result = UART_buffer[UART_rptr++];       // get data byte from buffer
-  UART_rptr &= (sizeof(UART_buffer) - 1);       // increase ring buffer read pointer
+  UART_rptr &= (UART_RX_BUF_SIZE - 1);          // increase ring buffer read pointer
   return result;                                // return the received byte
 }
 
 // Send byte via UART
 void UART_write(const char c) {
-  while(!UART_ready());                         // wait for ready to write
-  USART0.TXDATAL = c;                           // send character
+  while(!UART_txFree());                        // wait for space in TX buffer
+  UART_TX_buffer[UART_TX_wptr] = c;             // push byte to buffer
+  UART_TX_wptr = (UART_TX_wptr + 1) & (UART_TX_BUF_SIZE - 1);
+  USART0.CTRLA |= USART_DREIE_bm;               // enable data register empty interrupt
+}
+
+// Put buffer into TX buffer as far as it fits, return number of bytes taken
+uint8_t UART_writeBuffer(const char* buf, uint8_t len) {
+  uint8_t cnt = UART_txFree();                  // get free space in TX buffer
+  uint8_t wptr = UART_TX_wptr;                  // local copy of write pointer
+  if(cnt > len) cnt = len;                      // limit to buffer length
+  len = cnt;
+  while(cnt--) {                                // push bytes to buffer
+    UART_TX_buffer[wptr] = *buf++;
+    wptr = (wptr + 1) & (UART_TX_BUF_SIZE - 1);
+  }
+  UART_TX_wptr = wptr;                          // update write pointer
+  if(len) USART0.CTRLA |= USART_DREIE_bm;       // enable data register empty interrupt
+  return len;
 }
 
 // UART RXC interrupt service routine
 ISR(USART0_RXC_vect) {
   UART_buffer[UART_wptr++] = USART0.RXDATAL;    // push received byte to buffer...
-  UART_wptr &= (sizeof(UART_buffer) - 1);       // increase ring buffer write pointer
+  UART_wptr &= (UART_RX_BUF_SIZE - 1);          // increase ring buffer write pointer
+}
+
+// UART DRE interrupt service routine
+ISR(USART0_DRE_vect) {
+  if(UART_TX_rptr != UART_TX_wptr) {            // something in the TX buffer?
+    USART0.STATUS  = USART_TXCIF_bm;            // clear transmit complete flag
+    USART0.TXDATAL = UART_TX_buffer[UART_TX_rptr++]; // send byte from buffer
+    UART_TX_rptr  &= (UART_TX_BUF_SIZE - 1);    // increase ring buffer read pointer
+  }
+  else USART0.CTRLA &= ~USART_DREIE_bm;         // buffer empty -> disable interrupt
 }
@@ -1,5 +1,5 @@
 // ===================================================================================
-// USART0 with RX Interrupt and Ring Buffer for tinyAVR                       * v1.0 *
+// USART0 with RX/TX Interrupts and Ring Buffers for tinyAVR                 * v1.1 *
 // ===================================================================================
 //
 // Functions available:
@@ -12,12 +12,15 @@
 // UART_setOddParity()      Set parity bit, odd
 // UART_setEvenParity()     Set parity bit, even
 //
-// UART_ready()             Check if UART is ready to write
+// UART_ready()             Check if UART is ready to write (TX buffer not full)
 // UART_available()         Check if there is something to read
-// UART_completed()         Check if transmission is completed
+// UART_completed()         Check if transmission is completed (TX buffer empty)
+// UART_txFree()            Get number of free bytes in TX buffer
 //
 // UART_read()              Read character via UART
-// UART_write(c)            Send character via UART
+// UART_write(c)            Send character via UART (waits if TX buffer is full)
+// UART_writeBuffer(b,n)    Put buffer (b) with length (n) into TX buffer as far as it
+//                          fits, returns number of bytes taken (non-blocking)
 //
 // UART_TX_enable()         Enable transmitter
 // UART_TX_disable()        Disable transmitter
@@ -56,12 +59,15 @@ extern "C" {
 // UART parameters
 #define UART_BAUD             115200      // default UART baud rate
 #define UART_MAP              0           // UART pin mapping (see above)
+#define UART_RX_BUF_SIZE      64          // UART RX buffer size (must be power of 2)
+#define UART_TX_BUF_SIZE      32          // UART TX buffer size (must be power of 2)
 #define UART_PRINT            0           // 1: include print functions (needs print.h)
 
 // UART macros
 #define UART_available()      (UART_rptr != UART_wptr)            // something in buffer?
-#define UART_ready()          (USART0.STATUS & USART_DREIF_bm)    // ready to write
-#define UART_completed()      (USART0.STATUS & USART_TXCIF_bm)    // transmission completed
+#define UART_ready()          (UART_txFree())                     // ready to write
+#define UART_completed()      ((UART_TX_rptr == UART_TX_wptr) && (USART0.STATUS & USART_TXCIF_bm))
+#define UART_txFree()         ((UART_TX_rptr - UART_TX_wptr - 1) & (UART_TX_BUF_SIZE - 1))
 
 #define UART_TX_enable()      USART0.CTRLB |=  USART_TXEN_bm      // enable transmitter
 #define UART_TX_disable()     USART0.CTRLB &= ~USART_TXEN_bm      // disable transmitter
@@ -78,11 +84,14 @@ extern "C" {
 // UART variables
 extern volatile uint8_t UART_rptr;    // UART RX buffer read pointer
 extern volatile uint8_t UART_wptr;    // UART RX buffer write pointer
+extern volatile uint8_t UART_TX_rptr; // UART TX buffer read pointer
+extern volatile uint8_t UART_TX_wptr; // UART TX buffer write pointer
 
 // UART functions
 void UART_init(void);                 // init UART with default BAUD rate
 char UART_read(void);                 // read character via UART
 void UART_write(const char c);        // send character via UART
+uint8_t UART_writeBuffer(const char* buf, uint8_t len); // put buffer into TX buffer
 
 // Additional print functions (if activated, see above)
 #if UART_PRINT == 1
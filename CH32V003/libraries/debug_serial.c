@@ -1,5 +1,5 @@
 // ===================================================================================
-// Basic Serial Debug Functions for CH32V003                                  * v1.3 *
+// Basic Serial Debug Functions for CH32V003                                  * v1.4 *
 // ===================================================================================
 // 2023 by Stefan Wagner:   https://github.com/wagiminator
 
@@ -37,6 +37,11 @@ void DEBUG_init(void) {
   // Setup and start UART (8N1, TX, default BAUD rate)
   USART1->BRR     = ((2 * F_CPU / DEBUG_BAUD) + 1) / 2;
   USART1->CTLR1   = USART_CTLR1_TE | USART_CTLR1_UE;
+
+  // Enable USART1 interrupt for draining the trace buffer
+  #if DEBUG_TRACE > 0
+    NVIC_EnableIRQ(USART1_IRQn);
+  #endif
 }
 
 // Send byte via UART
@@ -187,4 +192,67 @@ void DEBUG_itoa(int32_t val, int8_t rad, int8_t len) {
   while(i);
 }
 
+// ===================================================================================
+// Binary Trace Logging
+// ===================================================================================
+#if DEBUG_TRACE > 0
+
+#if (DEBUG_TRACE_SIZE & (DEBUG_TRACE_SIZE - 1)) != 0
+  #error DEBUG_TRACE_SIZE must be a power of 2!
+#endif
+
+#define DEBUG_TRACE_SYNC  0xA5                  // start byte of a trace record
+
+// Trace ring buffer
+uint8_t DEBUG_TRACE_buffer[DEBUG_TRACE_SIZE];
+volatile uint16_t DEBUG_TRACE_head = 0;         // write pointer
+volatile uint16_t DEBUG_TRACE_tail = 0;         // read pointer (USART1 interrupt)
+volatile uint16_t DEBUG_TRACE_lost = 0;         // number of dropped records
+
+// Put byte into trace buffer (buffer space must have been checked)
+static inline void DEBUG_tracePut(uint8_t data) {
+  DEBUG_TRACE_buffer[DEBUG_TRACE_head] = data;
+  DEBUG_TRACE_head = (DEBUG_TRACE_head + 1) & (DEBUG_TRACE_SIZE - 1);
+}
+
+// Put 32-bit word into trace buffer (little-endian)
+static inline void DEBUG_tracePutW(uint32_t data) {
+  DEBUG_tracePut(data);
+  DEBUG_tracePut(data >> 8);
+  DEBUG_tracePut(data >> 16);
+  DEBUG_tracePut(data >> 24);
+}
+
+// Queue trace record, the address of the format string within the ".trace" section
+// serves as the ID, the record is dropped if it doesn't fit into the buffer
+void DEBUG_traceSend(const char* fmt, const uint32_t* arg, uint8_t argc) {
+  uint32_t time = STK->CNT;                     // get timestamp first
+  uint16_t len  = 8 + ((uint16_t)argc << 2);    // length of record
+  INT_ATOMIC_BLOCK {
+    if(len > ((DEBUG_TRACE_tail - DEBUG_TRACE_head - 1) & (DEBUG_TRACE_SIZE - 1)))
+      DEBUG_TRACE_lost++;                       // not enough space -> drop record
+    else {
+      DEBUG_tracePut(DEBUG_TRACE_SYNC);         // start byte
+      DEBUG_tracePut(argc);                     // number of arguments
+      DEBUG_tracePut((uint32_t)fmt);            // format string ID
+      DEBUG_tracePut((uint32_t)fmt >> 8);
+      DEBUG_tracePutW(time);                    // timestamp
+      while(argc--) DEBUG_tracePutW(*arg++);    // raw arguments
+      USART1->CTLR1 |= USART_CTLR1_TXEIE;       // start draining the buffer
+    }
+  }
+}
+
+// USART1 interrupt service routine (drain trace buffer)
+void USART1_IRQHandler(void) __attribute__((interrupt));
+void USART1_IRQHandler(void) {
+  if(DEBUG_TRACE_tail != DEBUG_TRACE_head) {    // something in the buffer?
+    USART1->DATAR = DEBUG_TRACE_buffer[DEBUG_TRACE_tail];
+    DEBUG_TRACE_tail = (DEBUG_TRACE_tail + 1) & (DEBUG_TRACE_SIZE - 1);
+  }
+  else USART1->CTLR1 &= ~USART_CTLR1_TXEIE;     // buffer empty -> stop interrupt
+}
+
+#endif // DEBUG_TRACE > 0
+
 #endif // DEBUG_ENABLE > 0
@@ -1,5 +1,5 @@
 // ===================================================================================
-// Basic Serial Debug Functions for CH32V003                                  * v1.3 *
+// Basic Serial Debug Functions for CH32V003                                  * v1.4 *
 // ===================================================================================
 //
 // Functions available:
@@ -18,6 +18,23 @@
 // DEBUG_newline()          Send newline
 // DEBUG_printf(s, ...)     Uses printf (supports %s, %c, %d, %u, %x, %b, %02d, %%)
 //
+// If binary trace logging is activated (see below, DEBUG_TRACE):
+// ---------------------------------------------------------------
+// DEBUG_trace(s, ...)      Send compact binary trace record (format string ID, SysTick
+//                          timestamp, raw 32-bit arguments) without rendering the
+//                          string. Non-blocking and interrupt-safe, can be used in ISRs.
+// DEBUG_traceLost()        Get number of records dropped because of full buffer
+//
+// Trace records are queued in a ring buffer which is drained by the USART1 interrupt.
+// The format strings are placed in the ".trace" linker section, which is kept in the
+// ELF file but does not occupy flash. Use tools/tracedec.py together with the ELF file
+// to rebuild the text on the host. Arguments for %s must be pointers to constant
+// strings (in flash) and must be cast to (uint32_t). Do not mix DEBUG_trace with the
+// text functions above, as their output would be interleaved.
+//
+// Trace record format (little-endian):
+// 0xA5 | number of args (n) | ID (16 bits) | timestamp (32 bits) | n x arg (32 bits)
+//
 // USART1 TX pin mapping (set below in UART parameters):
 // -----------------------------------------------------
 // DEBUG_TX   0     1     2     3
@@ -38,6 +55,13 @@ extern "C" {
 #define DEBUG_ENABLE      1                 // enable serial DEBUG (0:no, 1:yes)
 #define DEBUG_TX          0                 // UART TX pin mapping (see above)
 #define DEBUG_BAUD        115200            // default UART baud rate
+#define DEBUG_TRACE       0                 // 1: enable binary trace logging
+#define DEBUG_TRACE_SIZE  128               // trace buffer size (must be power of 2)
+
+// Interrupt enable check
+#if DEBUG_ENABLE > 0 && DEBUG_TRACE > 0 && SYS_USE_VECTORS == 0
+  #error Interrupt vector table must be enabled (SYS_USE_VECTORS in system.h)!
+#endif
 
 // DEBUG functions
 #if DEBUG_ENABLE > 0
@@ -62,6 +86,21 @@ extern "C" {
   #define DEBUG_printf(f, ...)
 #endif
 
+// DEBUG trace functions
+#if DEBUG_ENABLE > 0 && DEBUG_TRACE > 0
+  void DEBUG_traceSend(const char* fmt, const uint32_t* arg, uint8_t argc);
+  extern volatile uint16_t DEBUG_TRACE_lost;
+  #define DEBUG_traceLost() (DEBUG_TRACE_lost)
+  #define DEBUG_trace(f, ...) do {                                                    \
+    static const char DEBUG_fmt[] __attribute__((section(".trace"), used)) = f;      \
+    const uint32_t DEBUG_arg[] = {0, ##__VA_ARGS__};                                 \
+    DEBUG_traceSend(DEBUG_fmt, DEBUG_arg + 1, sizeof(DEBUG_arg) / 4 - 1);            \
+  } while(0)
+#else
+  #define DEBUG_trace(f, ...)
+  #define DEBUG_traceLost() 0
+#endif
+
 #define DEBUG_setBAUD(n)  USART1->BRR = ((2*F_CPU/(n))+1)/2;  // set BAUD rate
 #define DEBUG_newline()   DEBUG_write('\n') // send newline
 #define DEBUG_printS      DEBUG_print       // alias for print
@@ -0,0 +1,147 @@
+// ===================================================================================
+// Shared I2C Bus Scheduler with Priorities for CH32V003                      * v1.0 *
+// ===================================================================================
+// 2023 by Stefan Wagner:   https://github.com/wagiminator
+
+#include "i2c_bus.h"
+
+// Job queues (ring buffers of job pointers), index 0: normal, 1: high priority
+static BUS_JOB_TYPE* BUS_queue[2][BUS_QUEUE_SIZE];
+static volatile uint8_t BUS_head[2];              // next free slot
+static volatile uint8_t BUS_tail[2];              // next job to execute
+
+// Scheduler state
+static BUS_JOB_TYPE* BUS_current;                 // normal job, possibly between chunks
+static BUS_JOB_TYPE* BUS_running;                 // job of the active transaction
+static uint16_t      BUS_len;                     // bytes of txbuf in active transaction
+static uint32_t      BUS_start;                   // start time of active transaction
+volatile uint8_t     BUS_pending = 0;             // number of jobs running or waiting
+
+// Statistics
+BUS_STAT_TYPE   BUS_stats[BUS_CLIENTS];
+static uint32_t BUS_busyTicks;                    // total bus time since reset
+static uint32_t BUS_statStart;                    // time of last reset
+
+static void BUS_complete(uint8_t status);
+
+// Get next job of queue without removing it (0 if empty)
+static inline BUS_JOB_TYPE* BUS_peek(uint8_t prio) {
+  if(BUS_head[prio] == BUS_tail[prio]) return 0;
+  return BUS_queue[prio][BUS_tail[prio]];
+}
+
+// Remove next job from queue
+static inline void BUS_drop(uint8_t prio) {
+  BUS_tail[prio] = (BUS_tail[prio] + 1) & (BUS_QUEUE_SIZE - 1);
+}
+
+// Start next transaction (called with bus idle from interrupt or with INT disabled)
+static void BUS_next(void) {
+  uint8_t started;
+  BUS_JOB_TYPE* job = BUS_peek(BUS_PRIO_HIGH);    // high priority jobs first
+  if(!job) {
+    if(!BUS_current) {
+      BUS_current = BUS_peek(BUS_PRIO_NORMAL);
+      if(BUS_current) BUS_drop(BUS_PRIO_NORMAL);
+    }
+    job = BUS_current;                            // continue or start normal job
+  }
+  BUS_running = job;
+  if(!job) return;                                // nothing to do
+
+  // First transaction of this job? -> record waiting time
+  BUS_start = STK->CNT;
+  if(!job->done) {
+    uint32_t wait = BUS_start - job->queued;
+    if(wait > BUS_stats[job->client].maxWait) BUS_stats[job->client].maxWait = wait;
+  }
+
+  // Determine chunk and start transaction, rx only with the last chunk
+  BUS_len = job->txlen - job->done;
+  if(job->chunk && (BUS_len > job->chunk)) BUS_len = job->chunk;
+  if(job->done + BUS_len < job->txlen)
+    started = I2C_transferCmd(job->addr, job->cmd, job->txbuf + job->done, BUS_len,
+                              0, 0, BUS_complete);
+  else
+    started = I2C_transferCmd(job->addr, job->cmd, job->txbuf + job->done, BUS_len,
+                              job->rxbuf, job->rxlen, BUS_complete);
+
+  // I2C used directly by someone else? -> leave job queued, retry with BUS_poll()
+  if(!started) BUS_running = 0;
+}
+
+// Transaction completed (called from I2C interrupt)
+static void BUS_complete(uint8_t status) {
+  BUS_JOB_TYPE* job = BUS_running;
+  uint32_t time = STK->CNT - BUS_start;
+
+  // Update statistics
+  BUS_stats[job->client].busy += time;
+  BUS_busyTicks += time;
+
+  // Job done? -> callback
+  job->done += BUS_len;
+  if((status != I2C_OK) || (job->done >= job->txlen)) {
+    if(job == BUS_current) BUS_current = 0;     // normal job done
+    else BUS_drop(BUS_PRIO_HIGH);                 // high priority job done
+    BUS_stats[job->client].jobs++;
+    BUS_pending--;
+    if(job->callback) job->callback(status);
+  }
+
+  // Start next transaction
+  BUS_next();
+}
+
+// Init I2C and scheduler
+void BUS_init(void) {
+  I2C_init();
+  BUS_resetStats();
+}
+
+// Queue job, returns 0 if queue is full
+uint8_t BUS_submit(BUS_JOB_TYPE* job, uint8_t prio) {
+  uint8_t next;
+  prio = prio ? BUS_PRIO_HIGH : BUS_PRIO_NORMAL;
+  job->done   = 0;
+  job->queued = STK->CNT;
+  INT_ATOMIC_BLOCK {
+    next = (BUS_head[prio] + 1) & (BUS_QUEUE_SIZE - 1);
+    if(next == BUS_tail[prio]) prio = 0xFF;       // queue full -> reject
+    else {
+      BUS_queue[prio][BUS_head[prio]] = job;
+      BUS_head[prio] = next;
+      BUS_pending++;
+      if(!BUS_running) BUS_next();                // bus idle? -> start now
+    }
+  }
+  return(prio != 0xFF);
+}
+
+// Start waiting jobs if the scheduler was stalled by direct use of i2c_dma
+void BUS_poll(void) {
+  INT_ATOMIC_BLOCK {
+    if(BUS_pending && !BUS_running) BUS_next();
+  }
+}
+
+// Get bus utilisation in percent since last reset
+uint8_t BUS_utilisation(void) {
+  uint32_t total = (STK->CNT - BUS_statStart) / 100;
+  if(!total) return 0;
+  return BUS_busyTicks / total;
+}
+
+// Reset statistics
+void BUS_resetStats(void) {
+  uint8_t i;
+  INT_ATOMIC_BLOCK {
+    for(i=0; i<BUS_CLIENTS; i++) {
+      BUS_stats[i].jobs    = 0;
+      BUS_stats[i].busy    = 0;
+      BUS_stats[i].maxWait = 0;
+    }
+    BUS_busyTicks = 0;
+    BUS_statStart = STK->CNT;
+  }
+}
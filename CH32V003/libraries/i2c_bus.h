@@ -0,0 +1,126 @@
+// ===================================================================================
+// Shared I2C Bus Scheduler with Priorities for CH32V003                      * v1.0 *
+// ===================================================================================
+//
+// Several drivers on one I2C bus (e.g. OLED, BME280, INA219, EEPROM) queue their
+// transactions here instead of blocking the bus themselves. Jobs are executed from
+// interrupt one after the other using the asynchronous transactions of i2c_dma.
+// Large writes can be split into chunks, high priority jobs are inserted between the
+// chunks of a running job. Bus time and waiting time are recorded per client.
+//
+// Functions available:
+// --------------------
+// BUS_init()               Init I2C and the bus scheduler
+// BUS_submit(job,prio)     Queue job (pointer to BUS_JOB_TYPE) with priority (prio:
+//                          BUS_PRIO_HIGH or BUS_PRIO_NORMAL), returns 0 if queue is
+//                          full. The job and its buffers must not be changed until
+//                          its callback has been called.
+// BUS_busy()               Check if a job is running or waiting
+// BUS_wait()               Wait until all jobs are done
+// BUS_poll()               Start waiting jobs if the bus was blocked by a direct
+//                          i2c_dma transaction (called by BUS_wait())
+//
+// BUS_utilisation()        Get bus utilisation in percent since last BUS_resetStats()
+// BUS_maxWait(c)           Get worst-case wait of client (c) in SysTick ticks (queued
+//                          until first byte on the bus)
+// BUS_busyTime(c)          Get bus time used by client (c) in SysTick ticks
+// BUS_jobs(c)              Get number of finished jobs of client (c)
+// BUS_resetStats()         Reset all statistics (SysTick wraps after ~89s @ 48MHz)
+//
+// Job structure (BUS_JOB_TYPE, fill in before BUS_submit):
+// --------------------------------------------------------
+// addr                     8-bit device address (R/W bit ignored)
+// cmd                      command/control byte sent before txbuf (-1: none, note
+//                          that 0 is a valid command byte)
+// txbuf, txlen             bytes to write (txlen may be 0)
+// rxbuf, rxlen             bytes to read after repeated start (rxlen may be 0)
+// chunk                    max bytes of txbuf per transaction (0: don't split). Each
+//                          chunk is a complete transaction starting with cmd, so
+//                          only use it for devices which keep their address pointer
+//                          (e.g. SSD1306 horizontal addressing mode: chunk 128).
+//                          Chunks of a high priority job are not interrupted.
+// client                   client number for the statistics (< BUS_CLIENTS)
+// callback                 function f(status) called from interrupt when the job is
+//                          done (status: I2C_OK, I2C_ERR_NACK, I2C_ERR_BUS), can be 0
+//
+// Example: 1 KB SSD1306 refresh in 128 byte chunks, INA219 samples in between:
+//   BUS_JOB_TYPE oled = {.addr = 0x78, .cmd = 0x40, .txbuf = buf, .txlen = 1024,
+//                        .chunk = 128, .client = 0};
+//   BUS_submit(&oled, BUS_PRIO_NORMAL);
+//   ...
+//   BUS_JOB_TYPE ina = {.addr = 0x80, .cmd = 0x01, .rxbuf = val, .rxlen = 2,
+//                       .client = 1, .callback = INA_done};
+//   BUS_submit(&ina, BUS_PRIO_HIGH);
+//
+// All clients on the bus must use the scheduler, blocking I2C functions and direct
+// i2c_dma transactions (e.g. I2C_writeBuffer(), I2C_transfer() or an asynchronous
+// OLED_refresh()) must not be used while jobs are pending (BUS_wait() first). If a
+// job can't be started because i2c_dma is busy anyway, it stays queued until the
+// next BUS_submit() or BUS_poll().
+//
+// 2023 by Stefan Wagner:   https://github.com/wagiminator
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "system.h"
+#include "i2c_dma.h"
+
+// Bus Parameters
+#define BUS_QUEUE_SIZE      8           // jobs per priority queue (must be power of 2)
+#define BUS_CLIENTS         4           // number of clients for statistics
+
+#if (BUS_QUEUE_SIZE & (BUS_QUEUE_SIZE - 1))
+  #error BUS_QUEUE_SIZE must be a power of 2!
+#endif
+
+// Priorities
+#define BUS_PRIO_NORMAL     0           // executed in order of submission
+#define BUS_PRIO_HIGH       1           // executed before / between chunks of others
+
+// Job structure
+typedef struct {
+  uint8_t        addr;                  // 8-bit device address
+  int16_t        cmd;                   // command byte before txbuf (<0: none)
+  const uint8_t* txbuf;                 // transmit buffer
+  uint16_t       txlen;                 // number of bytes to transmit
+  uint8_t*       rxbuf;                 // receive buffer
+  uint16_t       rxlen;                 // number of bytes to receive
+  uint16_t       chunk;                 // max bytes per transaction (0: no split)
+  uint8_t        client;                // client number for statistics
+  void (*callback)(uint8_t status);     // called when job is done (can be 0)
+  uint16_t       done;                  // (internal) bytes of txbuf already sent
+  uint32_t       queued;                // (internal) time of submission
+} BUS_JOB_TYPE;
+
+// Statistics structure
+typedef struct {
+  uint32_t jobs;                        // number of finished jobs
+  uint32_t busy;                        // bus time in SysTick ticks
+  uint32_t maxWait;                     // worst-case wait in SysTick ticks
+} BUS_STAT_TYPE;
+
+// Bus Variables
+extern volatile uint8_t BUS_pending;    // number of jobs running or waiting
+extern BUS_STAT_TYPE BUS_stats[BUS_CLIENTS];
+
+// Bus Functions
+void BUS_init(void);                                  // init I2C and scheduler
+uint8_t BUS_submit(BUS_JOB_TYPE* job, uint8_t prio);  // queue job
+void BUS_poll(void);                                  // restart stalled scheduler
+uint8_t BUS_utilisation(void);                        // bus utilisation in percent
+void BUS_resetStats(void);                            // reset statistics
+
+// Bus Macros
+#define BUS_busy()          (BUS_pending)
+#define BUS_wait()          while(BUS_pending) BUS_poll()
+#define BUS_maxWait(c)      (BUS_stats[c].maxWait)
+#define BUS_busyTime(c)     (BUS_stats[c].busy)
+#define BUS_jobs(c)         (BUS_stats[c].jobs)
+
+#ifdef __cplusplus
+};
+#endif
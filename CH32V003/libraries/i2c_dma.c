@@ -1,5 +1,5 @@
 // ===================================================================================
-// Basic I2C Master Functions with DMA for TX for CH32V003                    * v1.1 *
+// I2C Master Functions with DMA and Asynchronous Transactions for CH32V003  * v1.2 *
 // ===================================================================================
 // 2023 by Stefan Wagner:   https://github.com/wagiminator
 
@@ -8,6 +8,24 @@
 // Read/write flag
 uint8_t I2C_rwflag;
 
+// States of the interrupt driven state machine
+enum {
+  I2C_STATE_IDLE = 0,                             // no transaction in progress
+  I2C_STATE_WRITE,                                // I2C_writeBuffer DMA in progress
+  I2C_STATE_TX,                                   // transaction: write phase
+  I2C_STATE_RX                                    // transaction: read phase
+};
+
+// Transaction variables
+volatile uint8_t I2C_state = I2C_STATE_IDLE;      // current state
+static uint8_t   I2C_addr;                        // device address (8-bit, write)
+static int16_t   I2C_cmd;                         // command byte before txbuf (<0: none)
+static const uint8_t* I2C_txbuf;                  // transmit buffer
+static uint16_t  I2C_txlen;                       // number of bytes to transmit
+static uint8_t*  I2C_rxbuf;                       // receive buffer
+static uint16_t  I2C_rxlen;                       // number of bytes to receive
+static void (*I2C_callback)(uint8_t status);      // called at end of transaction
+
 // Init I2C
 void I2C_init(void) {
   // Setup GPIO pins
@@ -43,20 +61,29 @@ void I2C_init(void) {
   #endif
   I2C1->CTLR1   = I2C_CTLR1_PE;                   // enable I2C
 
-  // Setup DMA Channel 5
+  // Setup DMA Channel 6 (TX)
   RCC->AHBPCENR |= RCC_DMA1EN;                    // enable DMA module clock
   DMA1_Channel6->PADDR = (uint32_t)&I2C1->DATAR;  // peripheral address
   DMA1_Channel6->CFGR  = DMA_CFG6_MINC            // increment memory address
                        | DMA_CFG6_DIR             // memory to I2C
                        | DMA_CFG6_TCIE;           // transfer complete interrupt enable
-  DMA1->INTFCR         = DMA_CGIF6;               // clear interrupt flags
-  NVIC_EnableIRQ(DMA1_Channel6_IRQn);             // enable the DMA IRQ
+
+  // Setup DMA Channel 7 (RX)
+  DMA1_Channel7->PADDR = (uint32_t)&I2C1->DATAR;  // peripheral address
+  DMA1_Channel7->CFGR  = DMA_CFG7_MINC            // increment memory address
+                       | DMA_CFG7_TCIE;           // transfer complete interrupt enable
+  DMA1->INTFCR         = DMA_CGIF6 | DMA_CGIF7;   // clear interrupt flags
+  NVIC_EnableIRQ(DMA1_Channel6_IRQn);             // enable the DMA IRQs
+  NVIC_EnableIRQ(DMA1_Channel7_IRQn);
+  NVIC_EnableIRQ(I2C1_EV_IRQn);                   // enable the I2C IRQs
+  NVIC_EnableIRQ(I2C1_ER_IRQn);
 }
 
 // Start I2C transmission (addr must contain R/W bit)
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-variable"
 void I2C_start(uint8_t addr) {
+  while(I2C_state);                               // wait for transaction finished
   while(I2C1->STAR2 & I2C_STAR2_BUSY);            // wait until bus ready
   I2C1->CTLR1 |= I2C_CTLR1_START                  // set START condition
                | I2C_CTLR1_ACK;                   // set ACK
@@ -92,25 +119,157 @@ void I2C_stop(void) {
   }
 }
 
-// Send data buffer via I2C bus using DMA
-void I2C_writeBuffer(uint8_t* buf, uint16_t len) {
+// Start DMA write of buffer to I2C (transfer complete interrupt follows)
+static inline void I2C_startTX(const uint8_t* buf, uint16_t len) {
   DMA1_Channel6->CNTR  = len;                     // number of bytes to be transfered
   DMA1_Channel6->MADDR = (uint32_t)buf;           // memory address
   DMA1_Channel6->CFGR |= DMA_CFG6_EN;             // enable DMA channel
   I2C1->CTLR2         |= I2C_CTLR2_DMAEN;         // enable DMA request
 }
 
-// Interrupt service routine
+// Send data buffer via I2C bus using DMA, STOP is set from interrupt
+void I2C_writeBuffer(uint8_t* buf, uint16_t len) {
+  I2C_rwflag = 1;                                 // I2C_stop() not necessary
+  I2C_state  = I2C_STATE_WRITE;
+  I2C_startTX(buf, len);
+}
+
+// Read data via I2C bus to buffer and stop
+void I2C_readBuffer(uint8_t* buf, uint16_t len) {
+  while(len--) *buf++ = I2C_read(len > 0);
+}
+
+// ===================================================================================
+// Asynchronous Transactions
+// ===================================================================================
+
+// Start non-blocking transaction: write cmd + txbuf, repeated start, read rxbuf
+uint8_t I2C_transferCmd(uint8_t addr, int16_t cmd, const uint8_t* txbuf, uint16_t txlen,
+                        uint8_t* rxbuf, uint16_t rxlen, void (*callback)(uint8_t status)) {
+  if(I2C_state) return 0;                         // transaction still in progress
+  I2C_addr     = addr & 0xFE;
+  I2C_cmd      = cmd;
+  I2C_txbuf    = txbuf;
+  I2C_txlen    = txlen;
+  I2C_rxbuf    = rxbuf;
+  I2C_rxlen    = rxlen;
+  I2C_callback = callback;
+  I2C_state    = (txlen || (cmd >= 0) || !rxlen) ? I2C_STATE_TX : I2C_STATE_RX;
+  I2C_rwflag   = 1;                               // I2C_stop() not necessary
+  I2C1->CTLR2 |= I2C_CTLR2_ITEVTEN                // enable event interrupt
+               | I2C_CTLR2_ITERREN;               // enable error interrupt
+  while(I2C1->CTLR1 & I2C_CTLR1_STOP);            // wait for STOP of last transaction
+  I2C1->CTLR1 |= I2C_CTLR1_START;                 // set START condition
+  return 1;
+}
+
+// Finish transaction and call callback
+static void I2C_finish(uint8_t status) {
+  I2C1->CTLR2 &= ~(I2C_CTLR2_ITEVTEN | I2C_CTLR2_ITERREN | I2C_CTLR2_DMAEN | I2C_CTLR2_LAST);
+  I2C_state = I2C_STATE_IDLE;
+  if(I2C_callback) I2C_callback(status);
+}
+
+// DMA TX complete: wait for last byte transmitted via BTF event interrupt
 void DMA1_Channel6_IRQHandler(void) __attribute__((interrupt));
 void DMA1_Channel6_IRQHandler(void) {
   I2C1->CTLR2         &= ~I2C_CTLR2_DMAEN;        // disable DMA request
   DMA1_Channel6->CFGR &= ~DMA_CFG6_EN;            // disable DMA channel
   DMA1->INTFCR         = DMA_CGIF6;               // clear interrupt flags
-  while(!(I2C1->STAR1 & I2C_STAR1_BTF));          // wait for last byte transmitted
-  I2C1->CTLR1         |= I2C_CTLR1_STOP;          // set STOP condition
+  I2C1->CTLR2         |= I2C_CTLR2_ITEVTEN;       // enable event interrupt (BTF)
 }
 
-// Read data via I2C bus to buffer and stop
-void I2C_readBuffer(uint8_t* buf, uint16_t len) {
-  while(len--) *buf++ = I2C_read(len > 0);
+// DMA RX complete: all bytes received
+void DMA1_Channel7_IRQHandler(void) __attribute__((interrupt));
+void DMA1_Channel7_IRQHandler(void) {
+  DMA1_Channel7->CFGR &= ~DMA_CFG7_EN;            // disable DMA channel
+  DMA1->INTFCR         = DMA_CGIF7;               // clear interrupt flags
+  if(I2C_rxlen > 1) I2C1->CTLR1 |= I2C_CTLR1_STOP;// set STOP condition
+  I2C_finish(I2C_OK);
+}
+
+// I2C event interrupt service routine
+void I2C1_EV_IRQHandler(void) __attribute__((interrupt));
+void I2C1_EV_IRQHandler(void) {
+  uint16_t star1, star2 __attribute__((unused));
+  star1 = I2C1->STAR1;
+
+  // Legacy DMA write finished -> STOP
+  if(I2C_state == I2C_STATE_WRITE) {
+    if(star1 & I2C_STAR1_BTF) {
+      I2C1->CTLR1 |= I2C_CTLR1_STOP;              // set STOP condition
+      I2C1->CTLR2 &= ~I2C_CTLR2_ITEVTEN;          // disable event interrupt
+      I2C_state = I2C_STATE_IDLE;
+    }
+    return;
+  }
+
+  // START generated -> send device address + R/W bit
+  if(star1 & I2C_STAR1_SB) {
+    I2C1->DATAR = (I2C_state == I2C_STATE_RX) ? (I2C_addr | 1) : I2C_addr;
+    return;
+  }
+
+  // Address transmitted -> start DMA transfer
+  if(star1 & I2C_STAR1_ADDR) {
+    if(I2C_state == I2C_STATE_TX) {
+      star2 = I2C1->STAR2;                        // clear ADDR flag
+      if(I2C_cmd >= 0) {                          // command byte?
+        I2C1->DATAR = I2C_cmd;                    // -> send it first
+        if(!I2C_txlen) return;                    // -> wait for BTF if no data
+      }
+      else if(!I2C_txlen) {                       // address probe only?
+        I2C1->CTLR1 |= I2C_CTLR1_STOP;            // -> set STOP condition
+        I2C_finish(I2C_OK);
+        return;
+      }
+      I2C1->CTLR2 &= ~I2C_CTLR2_ITEVTEN;          // wait for DMA complete instead
+      I2C_startTX(I2C_txbuf, I2C_txlen);
+      return;
+    }
+    DMA1_Channel7->CNTR  = I2C_rxlen;             // number of bytes to be received
+    DMA1_Channel7->MADDR = (uint32_t)I2C_rxbuf;   // memory address
+    DMA1_Channel7->CFGR |= DMA_CFG7_EN;           // enable DMA channel
+    I2C1->CTLR2 &= ~I2C_CTLR2_ITEVTEN;            // wait for DMA complete instead
+    if(I2C_rxlen == 1) {                          // single byte?
+      I2C1->CTLR1 &= ~I2C_CTLR1_ACK;              // -> NAK before clearing ADDR
+      star2 = I2C1->STAR2;                        // -> clear ADDR flag
+      I2C1->CTLR1 |= I2C_CTLR1_STOP;              // -> STOP after this byte
+      I2C1->CTLR2 |= I2C_CTLR2_DMAEN;             // -> enable DMA request
+    }
+    else {                                        // multiple bytes?
+      I2C1->CTLR1 |= I2C_CTLR1_ACK;               // -> ACK all but last byte
+      I2C1->CTLR2 |= I2C_CTLR2_DMAEN              // -> enable DMA request
+                   | I2C_CTLR2_LAST;              // -> NAK after last DMA byte
+      star2 = I2C1->STAR2;                        // -> clear ADDR flag
+    }
+    return;
+  }
+
+  // Last byte of write phase transmitted -> repeated START or STOP
+  if((star1 & I2C_STAR1_BTF) && (I2C_state == I2C_STATE_TX)) {
+    if(I2C_rxlen) {
+      I2C_state    = I2C_STATE_RX;
+      I2C1->CTLR1 |= I2C_CTLR1_START;             // set repeated START condition
+    }
+    else {
+      I2C1->CTLR1 |= I2C_CTLR1_STOP;              // set STOP condition
+      I2C_finish(I2C_OK);
+    }
+  }
+}
+
+// I2C error interrupt service routine
+void I2C1_ER_IRQHandler(void) __attribute__((interrupt));
+void I2C1_ER_IRQHandler(void) {
+  uint16_t star1 = I2C1->STAR1;
+  I2C1->STAR1 = ~(I2C_STAR1_BERR | I2C_STAR1_ARLO | I2C_STAR1_AF);  // clear error flags
+  I2C1->CTLR2         &= ~I2C_CTLR2_DMAEN;        // stop DMA
+  DMA1_Channel6->CFGR &= ~DMA_CFG6_EN;
+  DMA1_Channel7->CFGR &= ~DMA_CFG7_EN;
+  DMA1->INTFCR         = DMA_CGIF6 | DMA_CGIF7;
+  if(!(star1 & I2C_STAR1_ARLO))                   // still bus master?
+    I2C1->CTLR1 |= I2C_CTLR1_STOP;                // -> release the bus
+  if(I2C_state == I2C_STATE_WRITE) I2C_state = I2C_STATE_IDLE;
+  else I2C_finish((star1 & I2C_STAR1_AF) ? I2C_ERR_NACK : I2C_ERR_BUS);
 }
@@ -1,5 +1,5 @@
 // ===================================================================================
-// Basic I2C Master Functions with DMA for TX for CH32V003                    * v1.1 *
+// I2C Master Functions with DMA and Asynchronous Transactions for CH32V003  * v1.2 *
 // ===================================================================================
 //
 // Functions available:
@@ -16,6 +16,21 @@
 // I2C_writeBuffer(buf,len)     Write buffer (*buf) with length (len) via I2C and stop
 // I2C_readBuffer(buf,len)      Read buffer (*buf) with length (len) via I2C and stop
 //
+// I2C_transfer(addr,txbuf,txlen,rxbuf,rxlen,callback)
+//                          Start non-blocking transaction with device (addr): write
+//                          (txlen) bytes from (*txbuf), then repeated start and read
+//                          (rxlen) bytes to (*rxbuf). The whole sequence runs from
+//                          interrupts using DMA channels 6 (TX) and 7 (RX), at the end
+//                          callback(status) is called from interrupt (can be 0).
+//                          Returns 0 if a transaction is still in progress.
+// I2C_transferCmd(addr,cmd,txbuf,txlen,rxbuf,rxlen,callback)
+//                          Same as above, but send command/control byte (cmd) before
+//                          txbuf (e.g. OLED data mode or register address), cmd<0: none
+// I2C_transferBusy()       Check if a transaction (or DMA write) is in progress
+//
+// Transaction status: I2C_OK, I2C_ERR_NACK (device didn't acknowledge),
+//                     I2C_ERR_BUS (bus error or arbitration lost)
+//
 // I2C pin mapping (set below in I2C parameters):
 // ----------------------------------------------
 // I2C_MAP    0     1     2
@@ -42,6 +57,11 @@ extern "C" {
   #error Interrupt vector table must be enabled (SYS_USE_VECTORS in system.h)!
 #endif
 
+// Transaction status
+#define I2C_OK        0         // transaction completed
+#define I2C_ERR_NACK  1         // no acknowledge from device
+#define I2C_ERR_BUS   2         // bus error or arbitration lost
+
 // I2C Functions
 void I2C_init(void);              // I2C init function
 void I2C_start(uint8_t addr);     // I2C start transmission, addr must contain R/W bit
@@ -51,10 +71,17 @@ uint8_t I2C_read(uint8_t ack);    // I2C receive one data byte from the slave
 
 void I2C_writeBuffer(uint8_t* buf, uint16_t len);
 void I2C_readBuffer(uint8_t* buf, uint16_t len);
+uint8_t I2C_transferCmd(uint8_t addr, int16_t cmd, const uint8_t* txbuf, uint16_t txlen,
+                        uint8_t* rxbuf, uint16_t rxlen, void (*callback)(uint8_t status));
+
+extern volatile uint8_t I2C_state;  // state of the interrupt driven state machine
 
 #define I2C_sendBuffer(addr,buf,len)  {I2C_start(addr); I2C_writeBuffer(buf,len);}
 #define I2C_getBuffer(addr,buf,len)   {I2C_start(addr); I2C_readBuffer(buf,len);}
 #define I2C_busy()                    (I2C1->STAR2 & I2C_STAR2_BUSY)
+#define I2C_transferBusy()            (I2C_state)
+#define I2C_transfer(addr,txbuf,txlen,rxbuf,rxlen,callback) \
+        I2C_transferCmd(addr, -1, txbuf, txlen, rxbuf, rxlen, callback)
 
 #ifdef __cplusplus
 };
@@ -1,15 +1,32 @@
 // ===================================================================================
-// Basic I2C Slave Functions for CH32V003                                     * v1.0 *
+// I2C Slave with DMA Reads and optional Register Banks for CH32V003          * v1.1 *
 // ===================================================================================
 // 2024 by Stefan Wagner:   https://github.com/wagiminator
 
 #include "i2c_slave.h"
 
 // I2C slave registers
-uint8_t I2C_REG_ptr;                              // register pointer
 volatile uint8_t I2C_REG[I2C_REG_SIZE];           // register array
 volatile uint8_t I2C_FLAG_changed = 0;            // register change flag
+uint8_t I2C_RO[I2C_MASK_SIZE];                    // read-only mask
+static volatile uint8_t I2C_FLAG_rd  = 0;         // read transfer in progress
+
+#if I2C_BANKED > 0
+void (*I2C_callback)(uint8_t reg, uint8_t value) = 0;
+
+// Read banks (published snapshots) and write shadow bank
+static uint8_t I2C_BANK[2][I2C_REG_SIZE];         // published snapshots
+static volatile uint8_t I2C_BANK_pub = 0;         // bank to be read by the master
+static volatile uint8_t I2C_BANK_rd  = 0;         // bank of current read transfer
+static uint8_t I2C_SHADOW[I2C_REG_SIZE];          // registers written by the master
+static uint8_t I2C_WR_burst[I2C_MASK_SIZE];       // written in current burst
+static volatile uint8_t I2C_WR_pend[I2C_MASK_SIZE]; // written in completed bursts
+#define I2C_RD_BANK     I2C_BANK[I2C_BANK_rd]     // registers read by the master
+#else
+#define I2C_RD_BANK     I2C_REG                   // registers read by the master
+#endif
 
+uint8_t I2C_REG_ptr;                              // register pointer
 #if I2C_REG_SLCT > 0
 uint8_t I2C_FLAG_reg;
 #endif
@@ -38,6 +55,15 @@ void I2C_init(void) {
     #warning Wrong I2C REMAP
   #endif
 
+  // Setup DMA channel 6 for register reads of the master
+  RCC->AHBPCENR |= RCC_DMA1EN;                    // enable DMA module clock
+  DMA1_Channel6->PADDR = (uint32_t)&I2C1->DATAR;  // peripheral address
+  DMA1_Channel6->CFGR  = DMA_CFG6_MINC            // increment memory address
+                       | DMA_CFG6_DIR             // memory to I2C
+                       | DMA_CFG6_TCIE;           // transfer complete interrupt enable
+  DMA1->INTFCR         = DMA_CGIF6;               // clear interrupt flags
+  NVIC_EnableIRQ(DMA1_Channel6_IRQn);             // enable the DMA IRQ
+
   // Setup and enable I2C
   RCC->APB1PCENR |= RCC_I2C1EN;                   // enable I2C module clock
   I2C1->CTLR2     = 4                             // set input clock rate
@@ -54,15 +80,100 @@ void I2C_init(void) {
                   | I2C_CTLR1_PE;                 // enable I2C
 }
 
-// I2C slave interrupt service routine
+#if I2C_BANKED > 0
+// ===================================================================================
+// Register Bank Functions
+// ===================================================================================
+
+// Publish snapshot of I2C_REG[] for the master to read
+void I2C_publish(void) {
+  uint8_t i;
+  uint8_t bank = I2C_BANK_pub ^ 1;                // inactive bank
+  while(I2C_FLAG_rd && (I2C_BANK_rd == bank));    // still read from previous publish?
+  for(i=0; i<I2C_REG_SIZE; i++) I2C_BANK[bank][i] = I2C_REG[i];
+  I2C_BANK_pub = bank;                            // switch banks (atomic)
+}
+
+// Take over registers written by the master, returns number of registers
+uint8_t I2C_update(void) {
+  uint8_t i, pend[I2C_MASK_SIZE], value[I2C_REG_SIZE];
+  uint8_t cnt = 0;
+  INT_ATOMIC_BLOCK {                              // get consistent copy
+    for(i=0; i<I2C_MASK_SIZE; i++) {
+      pend[i] = I2C_WR_pend[i];
+      I2C_WR_pend[i] = 0;
+    }
+    for(i=0; i<I2C_REG_SIZE; i++) value[i] = I2C_SHADOW[i];
+    I2C_FLAG_changed = 0;
+  }
+  for(i=0; i<I2C_REG_SIZE; i++) {
+    if(pend[i >> 3] & (1 << (i & 7))) {
+      I2C_REG[i] = value[i];
+      if(I2C_callback) I2C_callback(i, value[i]);
+      cnt++;
+    }
+  }
+  return cnt;
+}
+
+// Discard registers written by the master
+void I2C_clear(void) {
+  uint8_t i;
+  INT_ATOMIC_BLOCK {
+    for(i=0; i<I2C_MASK_SIZE; i++) I2C_WR_pend[i] = 0;
+    I2C_FLAG_changed = 0;
+  }
+}
+#endif
+
+// ===================================================================================
+// Interrupt Service Routines
+// ===================================================================================
+
+// Finish read or write burst
+static inline void I2C_finish(void) {
+  if(I2C_FLAG_rd) {                               // read transfer?
+    DMA1_Channel6->CFGR &= ~DMA_CFG6_EN;          // -> stop DMA
+    DMA1->INTFCR         = DMA_CGIF6;
+    I2C1->CTLR2 = (I2C1->CTLR2 & ~I2C_CTLR2_DMAEN) | I2C_CTLR2_ITBUFEN;
+    I2C_FLAG_rd = 0;
+  }
+  #if I2C_BANKED > 0
+  uint8_t i, changed = 0;
+  for(i=0; i<I2C_MASK_SIZE; i++) {                // commit written registers
+    I2C_WR_pend[i] |= I2C_WR_burst[i];
+    changed |= I2C_WR_burst[i];
+    I2C_WR_burst[i] = 0;
+  }
+  if(changed) I2C_FLAG_changed = 1;
+  #endif
+}
+
+// I2C slave event interrupt service routine
 void I2C1_EV_IRQHandler(void) __attribute__((interrupt));
 void I2C1_EV_IRQHandler(void) {
-  uint16_t star1, star2 __attribute__((unused));
+  uint16_t star1, star2;
   star1 = I2C1->STAR1;
   star2 = I2C1->STAR2;
 
   // Address match handler
   if(star1 & I2C_STAR1_ADDR) {
+    I2C_finish();                                 // repeated start ends last burst
+    if(star2 & I2C_STAR2_TRA) {                   // master reads?
+      #if I2C_REG_SLCT == 0
+      I2C_REG_ptr = 0;                            // -> always start with register 0
+      #endif
+      #if I2C_BANKED > 0
+      I2C_BANK_rd = I2C_BANK_pub;                 // -> latch published bank
+      #endif
+      I2C_FLAG_rd = 1;
+      I2C1->CTLR2 &= ~I2C_CTLR2_ITBUFEN;          // -> bytes are supplied by DMA
+      DMA1_Channel6->MADDR = (uint32_t)&I2C_RD_BANK[I2C_REG_ptr];
+      DMA1_Channel6->CNTR  = I2C_REG_SIZE - I2C_REG_ptr;
+      DMA1_Channel6->CFGR |= DMA_CFG6_EN;
+      I2C1->CTLR2 |= I2C_CTLR2_DMAEN;
+      return;
+    }
     I2C_REG_ptr   = 0;                            // reset register pointer
     #if I2C_REG_SLCT > 0
     I2C_FLAG_reg  = 1;                            // first byte will be reg ptr
@@ -71,27 +182,37 @@ void I2C1_EV_IRQHandler(void) {
 
   // Byte received handler
   if(star1 & I2C_STAR1_RXNE) {
+    uint8_t data = I2C1->DATAR;
     #if I2C_REG_SLCT > 0
     if(I2C_FLAG_reg) {
-      I2C_REG_ptr = I2C1->DATAR;                  // read register address (pointer)
+      I2C_REG_ptr = data;                         // read register address (pointer)
       I2C_FLAG_reg = 0;                           // next bytes will be data
     }
     else
     #endif
     {
-      I2C_REG[I2C_REG_ptr++] = I2C1->DATAR;       // read register value from master
-      I2C_FLAG_changed = 1;                       // set register changed flag
+      if(!(I2C_RO[I2C_REG_ptr >> 3] & (1 << (I2C_REG_ptr & 7)))) { // not read-only?
+        #if I2C_BANKED > 0
+        I2C_SHADOW[I2C_REG_ptr] = data;           // write to shadow bank
+        I2C_WR_burst[I2C_REG_ptr >> 3] |= 1 << (I2C_REG_ptr & 7);
+        #else
+        I2C_REG[I2C_REG_ptr] = data;              // write register value
+        I2C_FLAG_changed = 1;                     // set register changed flag
+        #endif
+      }
+      I2C_REG_ptr++;
     }
   }
 
-  // Byte requested handler
-  if(star1 & I2C_STAR1_TXE) {
-    I2C1->DATAR = I2C_REG[I2C_REG_ptr++];         // send register value to master
+  // Byte requested handler (after DMA transfer, wrap around)
+  if((star1 & I2C_STAR1_TXE) && I2C_FLAG_rd) {
+    I2C1->DATAR = I2C_RD_BANK[I2C_REG_ptr++];     // send register value to master
   }
 
   // Stop condition handler
   if(star1 & I2C_STAR1_STOPF) {
     I2C1->CTLR1 &= ~(I2C_CTLR1_STOP);             // clear stop flag
+    I2C_finish();
   }
 
   // Wrap around register pointer
@@ -100,8 +221,18 @@ void I2C1_EV_IRQHandler(void) {
   }
 }
 
-// I2C error interrupt service routine
+// DMA transfer complete: end of register bank reached, continue with TXE interrupt
+void DMA1_Channel6_IRQHandler(void) __attribute__((interrupt));
+void DMA1_Channel6_IRQHandler(void) {
+  DMA1_Channel6->CFGR &= ~DMA_CFG6_EN;            // disable DMA channel
+  DMA1->INTFCR         = DMA_CGIF6;               // clear interrupt flags
+  I2C_REG_ptr          = 0;                       // wrap around
+  I2C1->CTLR2 = (I2C1->CTLR2 & ~I2C_CTLR2_DMAEN) | I2C_CTLR2_ITBUFEN;
+}
+
+// I2C error interrupt service routine (master NAKs the last byte it reads)
 void I2C1_ER_IRQHandler(void) __attribute__((interrupt));
 void I2C1_ER_IRQHandler(void) {
   I2C1->STAR1 &= ~(I2C_STAR1_BERR | I2C_STAR1_ARLO | I2C_STAR1_AF);
+  I2C_finish();
 }
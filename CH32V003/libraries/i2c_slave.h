@@ -1,15 +1,39 @@
 // ===================================================================================
-// Basic I2C Slave Functions Functions for CH32V003                           * v1.0 *
+// I2C Slave with DMA Reads and optional Register Banks for CH32V003          * v1.1 *
 // ===================================================================================
 //
+// The master reads the registers via DMA (auto-increment, wrap around at the end) and
+// writes them byte by byte from interrupt. Registers can be protected against writes
+// of the master with I2C_readOnly(reg).
+//
+// By default (I2C_BANKED 0) the master reads and writes I2C_REG[] directly as usual:
+// I2C_changed() is set by every register written, I2C_clear() clears this flag.
+//
+// With I2C_BANKED 1 the firmware works on I2C_REG[] and publishes a consistent
+// snapshot of all registers with I2C_publish(). The master always reads from the
+// last published snapshot, so multi-byte values are never torn, even during 400kHz
+// burst reads. Register writes of the master land in a shadow bank and are taken
+// over into I2C_REG[] by I2C_update() as a whole burst. Note that the master reads
+// zeros until the first I2C_publish() and that written registers only appear in
+// I2C_REG[] after I2C_update() and in the read bank with the next I2C_publish().
+//
 // Functions available:
 // --------------------
 // I2C_init()               init I2C slave device with parameters set below
 // I2C_busy()               check if I2C communication is currently on-going
-// I2C_changed()            check if something was changed in the slave registers
-// I2C_clear()              clear the changed flag
+// I2C_changed()            check if the master has written registers
+// I2C_clear()              I2C_BANKED 0: clear the changed flag
+//                          I2C_BANKED 1: discard registers written by the master
+// I2C_readOnly(reg)        protect register (reg) against writes of the master
+// I2C_readWrite(reg)       allow writes of the master to register (reg)
 // I2C_REG[]                slave register array
 //
+// Only with I2C_BANKED 1:
+// I2C_publish()            publish I2C_REG[] as new snapshot for the master to read
+// I2C_update()             take over written registers into I2C_REG[] and call the
+//                          write callback for each of them, returns number of regs
+// I2C_setCallback(f)       set function f(reg, value), called by I2C_update()
+//
 // I2C pin mapping (set below in I2C parameters):
 // ----------------------------------------------
 // I2C_MAP    0     1     2
@@ -42,6 +66,8 @@ extern "C" {
 
 #define I2C_REG_SLCT    0           // 0: transmission will always start with register 0
                                     // 1: first byte written is register address (pointer)
+#define I2C_BANKED      0           // 0: master reads/writes I2C_REG[] directly
+                                    // 1: double-buffered registers (see above)
 
 // Interrupt enable check
 #if SYS_USE_VECTORS == 0
@@ -49,15 +75,30 @@ extern "C" {
 #endif
 
 // I2C Slave Registers
+#define I2C_MASK_SIZE   ((I2C_REG_SIZE + 7) / 8)
 extern volatile uint8_t I2C_REG[];        // slave register array
 extern volatile uint8_t I2C_FLAG_changed; // slave register change flag
+extern uint8_t I2C_RO[];                  // read-only mask (one bit per register)
 
 // I2C Slave Functions and Macros
 void I2C_init(void);                // I2C slave init function
 
-#define I2C_busy()      (I2C1->STAR2 & I2C_STAR2_BUSY)
-#define I2C_changed()   (I2C_FLAG_changed)
-#define I2C_clear()     I2C_FLAG_changed = 0
+#define I2C_busy()          (I2C1->STAR2 & I2C_STAR2_BUSY)
+#define I2C_changed()       (I2C_FLAG_changed)
+#define I2C_readOnly(reg)   I2C_RO[(reg) >> 3] |=  (1 << ((reg) & 7))
+#define I2C_readWrite(reg)  I2C_RO[(reg) >> 3] &= ~(1 << ((reg) & 7))
+
+#if I2C_BANKED > 0
+extern void (*I2C_callback)(uint8_t reg, uint8_t value);
+
+void I2C_publish(void);             // publish snapshot of I2C_REG[]
+uint8_t I2C_update(void);           // take over registers written by the master
+void I2C_clear(void);               // discard registers written by the master
+
+#define I2C_setCallback(f)  I2C_callback = (f)
+#else
+#define I2C_clear()         I2C_FLAG_changed = 0
+#endif
 
 #ifdef __cplusplus
 };
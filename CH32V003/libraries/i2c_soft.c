@@ -1,9 +1,9 @@
 // ===================================================================================
-// Software I2C Master Functions                                              * v1.3 *
+// Software I2C Master Functions                                              * v1.4 *
 // ===================================================================================
 //
-// Simple I2C bitbanging. ACK bit of the slave is ignored. Clock stretching by the 
-// slave is not allowed. External pull-up resistors (4k7 - 10k) are mandatory!
+// Simple I2C bitbanging. ACK bit of the slave is ignored. Optional clock stretching.
+// External pull-up resistors (4k7 - 10k) are mandatory!
 //
 // Further information:     https://github.com/wagiminator/ATtiny13-TinyOLEDdemo
 // 2022 by Stefan Wagner:   https://github.com/wagiminator
@@ -11,21 +11,51 @@
 #include "i2c_soft.h"
 
 // ===================================================================================
-// I2C Delay
+// I2C Delay (cycle counted, calculated at compile time)
 // ===================================================================================
-#define I2C_DLY_TICKS_H   (((F_CPU *  9) / (I2C_CLKRATE * 25)) - 3)
-#define I2C_DLY_TICKS_L   (((F_CPU * 16) / (I2C_CLKRATE * 25)) - 12)
-
-#if I2C_DLY_TICKS_H >= 1
-  #define I2C_DELAY_H()   DLY_ticks(I2C_DLY_TICKS_H)
+#if I2C_STRETCH > 0
+  #define I2C_CYCLES_SCL  3                 // read SCL and branch after release
 #else
-  #define I2C_DELAY_H()
+  #define I2C_CYCLES_SCL  0
 #endif
 
-#if I2C_DLY_TICKS_L >= 1
-  #define I2C_DELAY_L()   DLY_ticks(I2C_DLY_TICKS_L)
-#else
-  #define I2C_DELAY_L()
+#define I2C_DLY_CYCLES_H  (((F_CPU *  9) / (I2C_CLKRATE * 25)) - I2C_CYCLES_H - I2C_CYCLES_SCL)
+#define I2C_DLY_CYCLES_L  (((F_CPU * 16) / (I2C_CLKRATE * 25)) - I2C_CYCLES_L)
+
+#if I2C_DLY_CYCLES_H < 0 || I2C_DLY_CYCLES_L < 0
+  #error I2C_CLKRATE is too high for this F_CPU!
+#endif
+
+// Delay n cycles: countdown loop for the bulk, single NOPs for the rest
+#define I2C_DELAY(n) { \
+  if((n) / I2C_CYCLES_LOOP) { \
+    uint32_t cnt = (n) / I2C_CYCLES_LOOP; \
+    __asm__ volatile("1: addi %0, %0, -1 \n bnez %0, 1b" : "+r" (cnt)); \
+  } \
+  __asm__ volatile(".rept %0 \n nop \n .endr" : : "i" ((n) % I2C_CYCLES_LOOP)); \
+}
+
+#define I2C_DELAY_H()     I2C_DELAY(I2C_DLY_CYCLES_H)
+#define I2C_DELAY_L()     I2C_DELAY(I2C_DLY_CYCLES_L)
+
+// ===================================================================================
+// I2C Clock Stretching
+// ===================================================================================
+#if I2C_STRETCH > 0
+#define I2C_STRETCH_LOOPS (I2C_STRETCH_TIMEOUT * (F_CPU / 1000000) / 8)
+
+volatile uint8_t I2C_error = 0;             // clock stretching timeout flag
+
+// Wait for SCL HIGH after it was released (slave stretches the clock)
+static void I2C_waitSCL(void) {
+  uint32_t cnt = I2C_STRETCH_LOOPS;
+  while(!PIN_read(PIN_SCL)) {
+    if(!--cnt) {                            // timeout?
+      I2C_error = 1;                        // -> set error flag
+      return;                               // -> continue anyway
+    }
+  }
+}
 #endif
 
 // ===================================================================================
@@ -33,11 +63,26 @@
 // ===================================================================================
 #define I2C_SDA_HIGH()  PIN_high(PIN_SDA)   // release SDA -> pulled HIGH by resistor
 #define I2C_SDA_LOW()   PIN_low(PIN_SDA)    // SDA LOW     -> pulled LOW  by MCU
+#if I2C_STRETCH > 0
+#define I2C_SCL_HIGH()  {PIN_high(PIN_SCL); if(!PIN_read(PIN_SCL)) I2C_waitSCL();}
+#else
 #define I2C_SCL_HIGH()  PIN_high(PIN_SCL)   // release SCL -> pulled HIGH by resistor
+#endif
 #define I2C_SCL_LOW()   PIN_low(PIN_SCL)    // SCL LOW     -> pulled LOW  by MCU
 #define I2C_SDA_READ()  PIN_read(PIN_SDA)   // read SDA pin
 #define I2C_CLOCKOUT()  I2C_DELAY_L();I2C_SCL_HIGH();I2C_DELAY_H();I2C_SCL_LOW()
 
+// Transmit one bit (mask b) of data
+#define I2C_WRITE_BIT(b) \
+  if(data & (b)) I2C_SDA_HIGH(); else I2C_SDA_LOW(); \
+  I2C_CLOCKOUT()
+
+// Receive one bit (mask b) into data
+#define I2C_READ_BIT(b) \
+  I2C_DELAY_L(); I2C_SCL_HIGH(); I2C_DELAY_H(); \
+  if(I2C_SDA_READ()) data |= (b); \
+  I2C_SCL_LOW()
+
 // ===================================================================================
 // I2C Functions
 // ===================================================================================
@@ -50,13 +95,12 @@ void I2C_init(void) {
   PIN_output_OD(PIN_SDA);                   // set SDA pin to open-drain OUTPUT
 }
 
-// I2C transmit one data byte to the slave, ignore ACK bit, no clock stretching allowed
+// I2C transmit one data byte to the slave, ignore ACK bit
 void I2C_write(uint8_t data) {
-  uint8_t i;
-  for(i=8; i; i--, data<<=1) {              // transmit 8 bits, MSB first
-    (data & 0x80) ? (I2C_SDA_HIGH()) : (I2C_SDA_LOW());  // SDA HIGH if bit is 1
-    I2C_CLOCKOUT();                         // clock out -> slave reads the bit
-  }
+  I2C_WRITE_BIT(0x80); I2C_WRITE_BIT(0x40); // transmit 8 bits, MSB first,
+  I2C_WRITE_BIT(0x20); I2C_WRITE_BIT(0x10); // unrolled for exact timing
+  I2C_WRITE_BIT(0x08); I2C_WRITE_BIT(0x04);
+  I2C_WRITE_BIT(0x02); I2C_WRITE_BIT(0x01);
   I2C_SDA_HIGH();                           // release SDA for ACK bit of slave
   I2C_CLOCKOUT();                           // 9th clock pulse is for the ignored ACK bit
 }
@@ -88,17 +132,12 @@ void I2C_stop(void) {
 
 // I2C receive one data byte from the slave (ack=0 for last byte, ack>0 if more bytes to follow)
 uint8_t I2C_read(uint8_t ack) {
-  uint8_t i;
   uint8_t data = 0;                         // variable for the received byte
   I2C_SDA_HIGH();                           // release SDA -> will be toggled by slave
-  for(i=8; i; i--) {                        // receive 8 bits
-    data <<= 1;                             // bits shifted in right (MSB first)
-    I2C_DELAY_L();                          // delay
-    I2C_SCL_HIGH();                         // clock HIGH
-    I2C_DELAY_H();                          // delay
-    if(I2C_SDA_READ()) data |= 1;           // read bit
-    I2C_SCL_LOW();                          // clock LOW -> slave prepares next bit
-  }
+  I2C_READ_BIT(0x80); I2C_READ_BIT(0x40);   // receive 8 bits, MSB first,
+  I2C_READ_BIT(0x20); I2C_READ_BIT(0x10);   // unrolled for exact timing
+  I2C_READ_BIT(0x08); I2C_READ_BIT(0x04);
+  I2C_READ_BIT(0x02); I2C_READ_BIT(0x01);
   if(ack) I2C_SDA_LOW();                    // pull SDA LOW to acknowledge (ACK)
   I2C_CLOCKOUT();                           // clock out -> slave reads ACK bit
   return data;                              // return the received byte
@@ -1,9 +1,20 @@
 // ===================================================================================
-// Software I2C Master Functions                                              * v1.3 *
+// Software I2C Master Functions                                              * v1.4 *
 // ===================================================================================
 //
-// Simple I2C bitbanging. ACK bit of the slave is ignored. Clock stretching by the 
-// slave is not allowed. External pull-up resistors (4k7 - 10k) are mandatory!
+// Simple I2C bitbanging. ACK bit of the slave is ignored. External pull-up resistors
+// (4k7 - 10k) are mandatory!
+//
+// The bit loops are unrolled and the delays are generated as inline instruction
+// sequences, which are calculated at compile time from F_CPU and I2C_CLKRATE. The
+// cycle calibration values below are estimates counted from the instruction
+// sequences, they have not been measured on the bus. The actual SCL timing may
+// differ, check it with a logic analyzer and adjust the values if exact timing is
+// needed. Clock rates above 400kHz are untested. If I2C_STRETCH is
+// enabled, the master waits for SCL to go HIGH after releasing it (clock stretching
+// by the slave and slow rising edges), the high time starts when SCL is really HIGH.
+// If SCL is held LOW longer than I2C_STRETCH_TIMEOUT, the transmission continues and
+// the error flag is set.
 //
 // Functions available:
 // --------------------
@@ -19,6 +30,9 @@
 // I2C_writeBuffer(buf,len)     Write buffer (*buf) with length (len) via I2C and stop
 // I2C_readBuffer(buf,len)      Read buffer (*buf) with length (len) via I2C and stop
 //
+// I2C_timeout()            Check if a clock stretching timeout occured
+// I2C_clearTimeout()       Clear timeout flag
+//
 // Define SDA/SCL pin and clock rate below!
 //
 // Further information:     https://github.com/wagiminator/ATtiny13-TinyOLEDdemo
@@ -39,6 +53,14 @@ extern "C" {
 #define PIN_SCL       PC2         // pin connected to serial clock of the I2C bus
 #endif
 #define I2C_CLKRATE   400000      // I2C bus clock rate in Hz
+#define I2C_STRETCH   0           // 1: support clock stretching by the slave
+#define I2C_STRETCH_TIMEOUT 1000  // max clock stretching time in us
+
+// Cycle calibration (estimated instruction cycles used besides the delays, @ 1 wait
+// state, not measured)
+#define I2C_CYCLES_H  6           // while SCL is HIGH (pin access, read SDA)
+#define I2C_CYCLES_L  10          // while SCL is LOW  (pin access, shift, set SDA)
+#define I2C_CYCLES_LOOP 4         // cycles per delay loop iteration
 
 // I2C Functions
 void I2C_init(void);              // I2C init function
@@ -54,6 +76,15 @@ void I2C_readBuffer(uint8_t* buf, uint16_t len);
 #define I2C_sendBuffer(addr,buf,len)  {I2C_start(addr); I2C_writeBuffer(buf,len);}
 #define I2C_getBuffer(addr,buf,len)   {I2C_start(addr); I2C_readBuffer(buf,len);}
 
+#if I2C_STRETCH > 0
+extern volatile uint8_t I2C_error;
+#define I2C_timeout()                 (I2C_error)
+#define I2C_clearTimeout()            I2C_error = 0
+#else
+#define I2C_timeout()                 (0)
+#define I2C_clearTimeout()
+#endif
+
 #ifdef __cplusplus
 };
 #endif
@@ -1,5 +1,5 @@
 // ===================================================================================
-// Basic NeoPixel Functions using Hardware-SPI and DMA for CH32V003           * v1.0 *
+// Basic NeoPixel Functions using Hardware-SPI and DMA for CH32V003           * v1.2 *
 // ===================================================================================
 // 2023 by Stefan Wagner:   https://github.com/wagiminator
 
@@ -22,7 +22,20 @@
 #error Unsupported system frequency for NeoPixels!
 #endif
 
+// Each DMA half buffer is sent within 64us (12 color bytes), encoding it takes about
+// 700 cycles, which is too slow below 24MHz
+#if NEO_STREAM > 0 && F_CPU < 24000000
+#error NEO_STREAM needs a system frequency of at least 24MHz!
+#endif
+
+#if NEO_STREAM > 0
+uint8_t  NEO_buffer[3 * NEO_COUNT];           // pixel buffer (color bytes)
+uint32_t NEO_DMA_buffer[2 * NEO_STREAM_CHUNK];// circular DMA buffer (two halves)
+uint16_t NEO_pos;                             // next color byte to be encoded
+uint8_t  NEO_pad;                             // halves filled with padding (bits)
+#else
 uint32_t NEO_buffer[3 * NEO_COUNT];           // pixel buffer
+#endif
 uint8_t  NEO_TX_flag = 0;                     // transfer running flag
 volatile uint32_t NEO_latch_end;              // latch timer
 
@@ -48,10 +61,19 @@ void NEO_init(void) {
   // Setup DMA Channel 3
   RCC->AHBPCENR |= RCC_DMA1EN;                    // enable DMA module clock
   DMA1_Channel3->PADDR = (uint32_t)&SPI1->DATAR;  // peripheral address
+  #if NEO_STREAM > 0
+  DMA1_Channel3->MADDR = (uint32_t)NEO_DMA_buffer;// memory address
+  DMA1_Channel3->CFGR  = DMA_CFGR3_MINC           // increment memory address
+                       | DMA_CFGR3_DIR            // memory to SPI
+                       | DMA_CFGR3_CIRC           // circular mode
+                       | DMA_CFGR3_HTIE           // half transfer interrupt enable
+                       | DMA_CFGR3_TCIE;          // transfer complete interrupt enable
+  #else
   DMA1_Channel3->MADDR = (uint32_t)NEO_buffer;    // memory address
   DMA1_Channel3->CFGR  = DMA_CFGR3_MINC           // increment memory address
-                       | DMA_CFGR3_DIR            // memory to I2C
+                       | DMA_CFGR3_DIR            // memory to SPI
                        | DMA_CFGR3_TCIE;          // transfer complete interrupt enable
+  #endif
   DMA1->INTFCR         = DMA_CGIF3;               // clear interrupt flags
   NVIC_EnableIRQ(DMA1_Channel3_IRQn);             // enable the DMA IRQ
 }
@@ -68,12 +90,38 @@ void NEO_latch(void) {
   else DLY_us(NEO_LATCH_TIME);                // or just delay the latch time
 }
 
+#if NEO_STREAM > 0
+// ===================================================================================
+// Encode next Chunk of Color Bytes into one Half of the circular DMA Buffer
+// ===================================================================================
+uint32_t NEO_SPI_mask(uint8_t data);
+
+static void NEO_fillHalf(uint8_t half) {
+  uint8_t  i, n;
+  uint8_t  *src = NEO_buffer + NEO_pos;
+  uint32_t *ptr = NEO_DMA_buffer + (half ? NEO_STREAM_CHUNK : 0);
+  uint16_t left = (3 * NEO_COUNT) - NEO_pos;  // color bytes left to be encoded
+  n = (left < NEO_STREAM_CHUNK) ? left : NEO_STREAM_CHUNK;
+  NEO_pos += n;
+  for(i=n; i; i--) *ptr++ = NEO_SPI_mask(*src++);
+  for(i=NEO_STREAM_CHUNK-n; i; i--) *ptr++ = 0; // pad with low level (latch)
+  if(!n) NEO_pad |= 1 << half;                // mark half as padding only
+}
+#endif
+
 // ===================================================================================
 // Start writing Buffer to Pixels via DMA
 // ===================================================================================
 void NEO_update(void) {
   NEO_latch();                                // make sure last data was latched
+  #if NEO_STREAM > 0
+  NEO_pos = 0; NEO_pad = 0;                   // start at first color byte
+  NEO_fillHalf(0);                            // encode both halves in advance
+  NEO_fillHalf(1);
+  DMA1_Channel3->CNTR  = 8 * NEO_STREAM_CHUNK;// size of circular buffer in bytes
+  #else
   DMA1_Channel3->CNTR  = 12 * NEO_COUNT;      // number of bytes to be transfered
+  #endif
   DMA1_Channel3->CFGR |= DMA_CFGR3_EN;        // enable DMA channel
   SPI1->CTLR2         |= SPI_CTLR2_TXDMAEN;   // enable DMA request
   NEO_TX_flag = 1;                            // set transmission flag
@@ -84,6 +132,14 @@ void NEO_update(void) {
 // ===================================================================================
 void DMA1_Channel3_IRQHandler(void) __attribute__((interrupt));
 void DMA1_Channel3_IRQHandler(void) {
+  #if NEO_STREAM > 0
+  uint8_t half = (DMA1->INTFR & DMA_TCIF3) ? 1 : 0; // half transmitted: HT->0, TC->1
+  DMA1->INTFCR = half ? DMA_CTCIF3 : DMA_CHTIF3;    // clear interrupt flag
+  if(!(NEO_pad & (1 << half))) {              // still data to be sent?
+    NEO_fillHalf(half);                       // encode next chunk into free half
+    return;
+  }
+  #endif
   SPI1->CTLR2         &= ~SPI_CTLR2_TXDMAEN;  // disable DMA request
   DMA1_Channel3->CFGR &= ~DMA_CFGR3_EN;       // disable DMA channel
   DMA1->INTFCR         =  DMA_CGIF3;          // clear interrupt flags    
@@ -94,10 +150,14 @@ void DMA1_Channel3_IRQHandler(void) {
 // Clear all Pixels
 // ===================================================================================
 void NEO_clearAll(void) {
-  uint8_t i;
-  uint32_t *ptr;
-  ptr = NEO_buffer;
+  uint16_t i;
+  #if NEO_STREAM > 0
+  uint8_t *ptr = NEO_buffer;
+  for(i=3*NEO_COUNT; i; i--) *ptr++ = 0;
+  #else
+  uint32_t *ptr = NEO_buffer;
   for(i=3*NEO_COUNT; i; i--) *ptr++ = 0x44444444;
+  #endif
   NEO_update();
 }
 
@@ -120,7 +180,17 @@ uint32_t NEO_SPI_mask(uint8_t data) {
 // ===================================================================================
 // Write Color to a Single Pixel in Buffer
 // ===================================================================================
-void NEO_writeColor(uint8_t pixel, uint8_t r, uint8_t g, uint8_t b) {
+void NEO_writeColor(uint16_t pixel, uint8_t r, uint8_t g, uint8_t b) {
+  #if NEO_STREAM > 0
+  uint8_t *ptr = NEO_buffer + (3 * pixel);
+  #if defined (NEO_GRB)
+    *ptr++ = g; *ptr++ = r; *ptr = b;
+  #elif defined (NEO_RGB)
+    *ptr++ = r; *ptr++ = g; *ptr = b;
+  #else
+    #error Wrong or missing NeoPixel type definition!
+  #endif
+  #else
   uint32_t *ptr;
   ptr = NEO_buffer + (3 * pixel);
   #if defined (NEO_GRB)
@@ -134,12 +204,13 @@ void NEO_writeColor(uint8_t pixel, uint8_t r, uint8_t g, uint8_t b) {
   #else
     #error Wrong or missing NeoPixel type definition!
   #endif
+  #endif
 }
 
 // ===================================================================================
 // Write Hue Value (0..191) and Brightness (0..2) to a Single Pixel in Buffer
 // ===================================================================================
-void NEO_writeHue(uint8_t pixel, uint8_t hue, uint8_t bright) {
+void NEO_writeHue(uint16_t pixel, uint8_t hue, uint8_t bright) {
   uint8_t phase = hue >> 6;
   uint8_t step  = (hue & 63) << bright;
   uint8_t nstep = (63 << bright) - step;
@@ -154,6 +225,6 @@ void NEO_writeHue(uint8_t pixel, uint8_t hue, uint8_t bright) {
 // ===================================================================================
 // Clear Single Pixel in Buffer
 // ===================================================================================
-void NEO_clearPixel(uint8_t pixel) {
+void NEO_clearPixel(uint16_t pixel) {
   NEO_writeColor(pixel, 0, 0, 0);
 }
@@ -1,5 +1,5 @@
 // ===================================================================================
-// Basic NeoPixel Functions using Hardware-SPI and DMA for CH32V003           * v1.0 *
+// Basic NeoPixel Functions using Hardware-SPI and DMA for CH32V003           * v1.2 *
 // ===================================================================================
 //
 // Functions available:
@@ -18,6 +18,14 @@
 // - Works with most 800kHz addressable LEDs (NeoPixels).
 // - Set number of pixels and pixel type in the parameters below!
 // - System clock frequency must be 48MHz, 24MHz, 12MHz, or 6MHz.
+// - By default every color byte is pre-encoded into a 32-bit SPI bit mask, which
+//   takes 12 bytes of RAM per pixel. With NEO_STREAM = 1 only the 3 color bytes
+//   per pixel are kept and a small circular DMA buffer is encoded on the fly by the
+//   half-transfer and transfer-complete interrupts (4x less RAM for long strings).
+//   NEO_STREAM_CHUNK color bytes are encoded per interrupt. Each half is sent within
+//   64us (12 color bytes), encoding it takes about 700 cycles, therefore stream mode
+//   needs a system frequency of 24MHz or 48MHz and other interrupts must not delay
+//   the DMA interrupt for long.
 //
 // 2023 by Stefan Wagner:   https://github.com/wagiminator
 
@@ -39,6 +47,11 @@ extern "C" {
 #define NEO_GRB               // type of pixels: NEO_GRB or NEO_RGB
 #define NEO_LATCH_TIME  281   // latch time in microseconds
 
+#ifndef NEO_STREAM
+#define NEO_STREAM      0     // 1: encode on the fly (3 bytes RAM per pixel)
+#endif
+#define NEO_STREAM_CHUNK 12   // color bytes per DMA half buffer (stream mode)
+
 // ===================================================================================
 // Interrupt enable check
 // ===================================================================================
@@ -52,9 +65,9 @@ extern "C" {
 void NEO_init(void);
 void NEO_update(void);
 void NEO_clearAll(void);
-void NEO_writeColor(uint8_t pixel, uint8_t r, uint8_t g, uint8_t b);
-void NEO_writeHue(uint8_t pixel, uint8_t hue, uint8_t bright);
-void NEO_clearPixel(uint8_t pixel);
+void NEO_writeColor(uint16_t pixel, uint8_t r, uint8_t g, uint8_t b);
+void NEO_writeHue(uint16_t pixel, uint8_t hue, uint8_t bright);
+void NEO_clearPixel(uint16_t pixel);
 
 #ifdef __cplusplus
 };
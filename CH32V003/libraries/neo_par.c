@@ -0,0 +1,190 @@
+// ===================================================================================
+// Parallel NeoPixel Functions using Timer-triggered DMA for CH32V003         * v1.0 *
+// ===================================================================================
+// 2023 by Stefan Wagner:   https://github.com/wagiminator
+
+#include "neo_par.h"
+
+// ===================================================================================
+// Timer Parameters and Variables
+// ===================================================================================
+
+// Timer ticks per bit (800kHz); "0"-bits go low after 1/3, "1"-bits after 2/3 of it
+#if F_CPU == 48000000 || F_CPU == 24000000
+#define NEO_PERIOD  (F_CPU / 800000)
+#else
+#error Unsupported system frequency for NeoPixels!
+#endif
+
+#define NEO_PORT_EN \
+  ((NEO_PORT == GPIOA) ? ( RCC_IOPAEN ) : \
+  ((NEO_PORT == GPIOC) ? ( RCC_IOPCEN ) : \
+  ((NEO_PORT == GPIOD) ? ( RCC_IOPDEN ) : \
+(0))))
+
+uint8_t NEO_buffer[24 * NEO_COUNT];           // bit-transposed pixel buffer
+const uint32_t NEO_pins = NEO_PINS;           // pin mask as DMA source
+uint8_t NEO_TX_flag = 0;                      // transfer running flag
+volatile uint32_t NEO_latch_end;              // latch timer
+
+// ===================================================================================
+// Init GPIO, Timer and DMA for parallel Neopixels
+// ===================================================================================
+void NEO_init(void) {
+  uint16_t i;
+  uint32_t cfg;
+  uint8_t  *ptr;
+
+  // Clear buffer (all bits "0")
+  ptr = NEO_buffer;
+  for(i=24*NEO_COUNT; i; i--) *ptr++ = NEO_PINS;
+
+  // Setup GPIO pins (output, push-pull, 50MHz, low)
+  RCC->APB2PCENR |= NEO_PORT_EN;
+  NEO_PORT->BCR = NEO_PINS;
+  cfg = NEO_PORT->CFGLR;
+  for(i=0; i<8; i++) {
+    if(NEO_PINS & (1 << i)) cfg = (cfg & ~((uint32_t)0b1111<<(i<<2))) | ((uint32_t)0b0011<<(i<<2));
+  }
+  NEO_PORT->CFGLR = cfg;
+
+  // Setup timer 2 as bit clock
+  RCC->APB1PCENR |= RCC_TIM2EN;                   // enable timer module clock
+  TIM2->PSC    = 0;                               // no prescaler
+  TIM2->ATRLR  = NEO_PERIOD - 1;                  // 1.25us per bit
+  TIM2->CH1CVR = NEO_PERIOD / 3;                  // "0"-bits low after 417ns
+  TIM2->CH2CVR = NEO_PERIOD * 2 / 3;              // "1"-bits low after 833ns
+
+  // Setup DMA channel 2 (TIM2 update): set all pins high at start of bit
+  RCC->AHBPCENR |= RCC_DMA1EN;                    // enable DMA module clock
+  DMA1_Channel2->PADDR = (uint32_t)&NEO_PORT->BSHR;// peripheral address
+  DMA1_Channel2->MADDR = (uint32_t)&NEO_pins;     // memory address
+  DMA1_Channel2->CFGR  = DMA_CFGR1_DIR            // memory to GPIO
+                       | DMA_CFGR1_PSIZE_1        // peripheral size 32 bits
+                       | DMA_CFGR1_MSIZE_1        // memory size 32 bits
+                       | DMA_CFGR1_PL;            // very high priority
+
+  // Setup DMA channel 5 (TIM2 compare 1): pull pins with "0"-bit low
+  DMA1_Channel5->PADDR = (uint32_t)&NEO_PORT->BCR;// peripheral address
+  DMA1_Channel5->MADDR = (uint32_t)NEO_buffer;    // memory address
+  DMA1_Channel5->CFGR  = DMA_CFGR1_MINC           // increment memory address
+                       | DMA_CFGR1_DIR            // memory to GPIO
+                       | DMA_CFGR1_PSIZE_1        // peripheral size 32 bits
+                       | DMA_CFGR1_PL;            // very high priority
+
+  // Setup DMA channel 7 (TIM2 compare 2): pull all pins low
+  DMA1_Channel7->PADDR = (uint32_t)&NEO_PORT->BCR;// peripheral address
+  DMA1_Channel7->MADDR = (uint32_t)&NEO_pins;     // memory address
+  DMA1_Channel7->CFGR  = DMA_CFGR1_DIR            // memory to GPIO
+                       | DMA_CFGR1_PSIZE_1        // peripheral size 32 bits
+                       | DMA_CFGR1_MSIZE_1        // memory size 32 bits
+                       | DMA_CFGR1_PL             // very high priority
+                       | DMA_CFGR1_TCIE;          // transfer complete interrupt enable
+  DMA1->INTFCR         = DMA_CGIF7;               // clear interrupt flags
+  NVIC_EnableIRQ(DMA1_Channel7_IRQn);             // enable the DMA IRQ
+}
+
+// ===================================================================================
+// Latch the Data
+// ===================================================================================
+void NEO_latch(void) {
+  if(NEO_TX_flag) {
+    while(TIM2->CTLR1 & TIM_CEN);             // wait for end of last transmission
+    while(((int32_t)(STK->CNT - NEO_latch_end)) < 0); // wait for end of latch
+    NEO_TX_flag = 0;                          // clear transmission flag
+  }
+  else DLY_us(NEO_LATCH_TIME);                // or just delay the latch time
+}
+
+// ===================================================================================
+// Start writing Buffer to all Pixel Strings via DMA
+// ===================================================================================
+void NEO_update(void) {
+  NEO_latch();                                // make sure last data was latched
+  DMA1_Channel2->CNTR  = 24 * NEO_COUNT;      // number of bits to be transfered
+  DMA1_Channel5->CNTR  = 24 * NEO_COUNT;
+  DMA1_Channel7->CNTR  = 24 * NEO_COUNT;
+  DMA1_Channel2->CFGR |= DMA_CFGR1_EN;        // enable DMA channels
+  DMA1_Channel5->CFGR |= DMA_CFGR1_EN;
+  DMA1_Channel7->CFGR |= DMA_CFGR1_EN;
+  NEO_TX_flag = 1;                            // set transmission flag
+  TIM2->CNT        = NEO_PERIOD - 1;          // first event is update (start of bit)
+  TIM2->DMAINTENR  = TIM_UDE | TIM_CC1DE | TIM_CC2DE; // enable DMA requests
+  TIM2->CTLR1      = TIM_CEN;                 // start timer
+}
+
+// ===================================================================================
+// Interrupt Service Routine (last bit sent)
+// ===================================================================================
+void DMA1_Channel7_IRQHandler(void) __attribute__((interrupt));
+void DMA1_Channel7_IRQHandler(void) {
+  TIM2->CTLR1          = 0;                   // stop timer
+  TIM2->DMAINTENR      = 0;                   // disable (and clear) DMA requests
+  DMA1_Channel2->CFGR &= ~DMA_CFGR1_EN;       // disable DMA channels
+  DMA1_Channel5->CFGR &= ~DMA_CFGR1_EN;
+  DMA1_Channel7->CFGR &= ~DMA_CFGR1_EN;
+  DMA1->INTFCR         =  DMA_CGIF7;          // clear interrupt flags
+  NEO_latch_end = STK->CNT + ((NEO_LATCH_TIME + 5) * DLY_US_TIME);  // end of latch
+}
+
+// ===================================================================================
+// Clear all Pixels
+// ===================================================================================
+void NEO_clearAll(void) {
+  uint16_t i;
+  uint8_t *ptr;
+  ptr = NEO_buffer;
+  for(i=24*NEO_COUNT; i; i--) *ptr++ = NEO_PINS;
+  NEO_update();
+}
+
+// ===================================================================================
+// Write Color Byte of one String into the transposed Buffer (8 bytes, MSB first)
+// ===================================================================================
+static void NEO_writeByte(uint8_t* ptr, uint8_t mask, uint8_t data) {
+  uint8_t i;
+  for(i=8; i; i--, data<<=1, ptr++) {
+    if(data & 0x80) *ptr &= ~mask;            // "1"-bit: stay high until compare 2
+    else            *ptr |=  mask;            // "0"-bit: pull low at compare 1
+  }
+}
+
+// ===================================================================================
+// Write Color to a Single Pixel of a String in Buffer
+// ===================================================================================
+void NEO_writeColor(uint8_t string, uint16_t pixel, uint8_t r, uint8_t g, uint8_t b) {
+  uint8_t *ptr;
+  uint8_t mask = (1 << string) & NEO_PINS;    // pin of the string
+  if(!mask || (pixel >= NEO_COUNT)) return;
+  ptr = NEO_buffer + (24 * pixel);
+  #if defined (NEO_GRB)
+    NEO_writeByte(ptr, mask, g); NEO_writeByte(ptr + 8, mask, r);
+  #elif defined (NEO_RGB)
+    NEO_writeByte(ptr, mask, r); NEO_writeByte(ptr + 8, mask, g);
+  #else
+    #error Wrong or missing NeoPixel type definition!
+  #endif
+  NEO_writeByte(ptr + 16, mask, b);
+}
+
+// ===================================================================================
+// Write Hue Value (0..191) and Brightness (0..2) to a Single Pixel in Buffer
+// ===================================================================================
+void NEO_writeHue(uint8_t string, uint16_t pixel, uint8_t hue, uint8_t bright) {
+  uint8_t phase = hue >> 6;
+  uint8_t step  = (hue & 63) << bright;
+  uint8_t nstep = (63 << bright) - step;
+  switch(phase) {
+    case 0:   NEO_writeColor(string, pixel, nstep,  step,     0); break;
+    case 1:   NEO_writeColor(string, pixel,     0, nstep,  step); break;
+    case 2:   NEO_writeColor(string, pixel,  step,     0, nstep); break;
+    default:  break;
+  }
+}
+
+// ===================================================================================
+// Clear Single Pixel of a String in Buffer
+// ===================================================================================
+void NEO_clearPixel(uint8_t string, uint16_t pixel) {
+  NEO_writeColor(string, pixel, 0, 0, 0);
+}
@@ -0,0 +1,79 @@
+// ===================================================================================
+// Parallel NeoPixel Functions using Timer-triggered DMA for CH32V003         * v1.0 *
+// ===================================================================================
+//
+// Functions available:
+// --------------------
+// NEO_init()                 init GPIO, timer and DMA for parallel NeoPixel strings
+// NEO_clearAll()             clear all pixels of all strings and update
+// NEO_clearPixel(s,p)        clear pixel p of string s
+// NEO_writeColor(s,p,r,g,b)  write RGB color to pixel p of string s
+// NEO_writeHue(s,p,h,b)      write hue (h=0..191) and brightness (b=0..2) to pixel p
+// NEO_update()               update all strings in parallel (write buffer to pixels)
+// NEO_latch()                latch the data sent
+//
+// Notes:
+// ------
+// - Drives up to 8 NeoPixel strings at once from one GPIO port. String s is
+//   connected to pin s of the port (e.g. string 3 to PC3 on NEO_PORT GPIOC).
+//   Select the strings in use with NEO_PINS (bitmap), other pins of the port
+//   are not touched.
+// - The pixel buffer is bit-transposed: each byte holds one bit of the same
+//   color byte of all strings. It takes 3 bytes of RAM per pixel and string.
+// - TIM2 generates the 800kHz bit clock. Three DMA channels triggered by update
+//   (channel 2), compare 1 (channel 5) and compare 2 (channel 7) set all pins
+//   high, pull the "0"-bit pins low and pull all pins low. The CPU is free during
+//   transmission and the refresh time is set by NEO_COUNT (the longest string)
+//   independent of the number of strings.
+// - TIM2 and DMA channels 2, 5 and 7 must not be used by other functions.
+// - System clock frequency must be 48MHz or 24MHz.
+//
+// 2023 by Stefan Wagner:   https://github.com/wagiminator
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "system.h"
+
+// ===================================================================================
+// NeoPixel Definitions
+// ===================================================================================
+#ifndef NEO_COUNT
+#define NEO_COUNT       8     // number of pixels per string (longest string)
+#endif
+
+#ifndef NEO_PORT
+#define NEO_PORT        GPIOC // GPIO port of the strings (GPIOA, GPIOC or GPIOD)
+#endif
+
+#ifndef NEO_PINS
+#define NEO_PINS        0x0F  // pins of port used for strings (bitmap, 0x01..0xFF)
+#endif
+
+#define NEO_GRB               // type of pixels: NEO_GRB or NEO_RGB
+#define NEO_LATCH_TIME  281   // latch time in microseconds
+
+// ===================================================================================
+// Interrupt enable check
+// ===================================================================================
+#if SYS_USE_VECTORS == 0
+  #error Interrupt vector table must be enabled (SYS_USE_VECTORS in system.h)!
+#endif
+
+// ===================================================================================
+// NeoPixel Functions and Macros
+// ===================================================================================
+void NEO_init(void);
+void NEO_update(void);
+void NEO_latch(void);
+void NEO_clearAll(void);
+void NEO_writeColor(uint8_t string, uint16_t pixel, uint8_t r, uint8_t g, uint8_t b);
+void NEO_writeHue(uint8_t string, uint16_t pixel, uint8_t hue, uint8_t bright);
+void NEO_clearPixel(uint8_t string, uint16_t pixel);
+
+#ifdef __cplusplus
+};
+#endif
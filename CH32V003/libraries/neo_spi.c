@@ -1,5 +1,5 @@
 // ===================================================================================
-// Basic NeoPixel Functions using Hardware-SPI for CH32V003                   * v1.1 *
+// Basic NeoPixel Functions using Hardware-SPI for CH32V003                   * v1.2 *
 // ===================================================================================
 // 2023 by Stefan Wagner:   https://github.com/wagiminator
 
@@ -63,7 +63,7 @@ void NEO_sendByte(uint8_t data) {
 // Write Buffer to Pixels
 // ===================================================================================
 void NEO_update(void) {
-  uint8_t i;
+  uint16_t i;
   uint8_t *ptr;
   ptr = NEO_buffer;
   for(i=3*NEO_COUNT; i; i--) NEO_sendByte(*ptr++);
@@ -74,7 +74,7 @@ void NEO_update(void) {
 // Clear all Pixels
 // ===================================================================================
 void NEO_clearAll(void) {
-  uint8_t i;
+  uint16_t i;
   uint8_t *ptr;
   ptr = NEO_buffer;
   for(i=3*NEO_COUNT; i; i--) *ptr++ = 0;
@@ -84,7 +84,7 @@ void NEO_clearAll(void) {
 // ===================================================================================
 // Write Color to a Single Pixel in Buffer
 // ===================================================================================
-void NEO_writeColor(uint8_t pixel, uint8_t r, uint8_t g, uint8_t b) {
+void NEO_writeColor(uint16_t pixel, uint8_t r, uint8_t g, uint8_t b) {
   uint8_t *ptr;
   ptr = NEO_buffer + (3 * pixel);
   #if defined (NEO_GRB)
@@ -99,7 +99,7 @@ void NEO_writeColor(uint8_t pixel, uint8_t r, uint8_t g, uint8_t b) {
 // ===================================================================================
 // Write Hue Value (0..191) and Brightness (0..2) to a Single Pixel in Buffer
 // ===================================================================================
-void NEO_writeHue(uint8_t pixel, uint8_t hue, uint8_t bright) {
+void NEO_writeHue(uint16_t pixel, uint8_t hue, uint8_t bright) {
   uint8_t phase = hue >> 6;
   uint8_t step  = (hue & 63) << bright;
   uint8_t nstep = (63 << bright) - step;
@@ -114,6 +114,6 @@ void NEO_writeHue(uint8_t pixel, uint8_t hue, uint8_t bright) {
 // ===================================================================================
 // Clear Single Pixel in Buffer
 // ===================================================================================
-void NEO_clearPixel(uint8_t pixel) {
+void NEO_clearPixel(uint16_t pixel) {
   NEO_writeColor(pixel, 0, 0, 0);
 }
@@ -1,5 +1,5 @@
 // ===================================================================================
-// Basic NeoPixel Functions using Software Bit-banging for CH32V003           * v1.0 *
+// Basic NeoPixel Functions using Software Bit-banging for CH32V003           * v1.1 *
 // ===================================================================================
 //
 // Basic control functions for 800kHz addressable LEDs (NeoPixel). A simplified 
@@ -55,9 +55,9 @@ void NEO_init(void);
 void NEO_sendByte(uint8_t data);
 void NEO_update(void);
 void NEO_clearAll(void);
-void NEO_writeColor(uint8_t pixel, uint8_t r, uint8_t g, uint8_t b);
-void NEO_writeHue(uint8_t pixel, uint8_t hue, uint8_t bright);
-void NEO_clearPixel(uint8_t pixel);
+void NEO_writeColor(uint16_t pixel, uint8_t r, uint8_t g, uint8_t b);
+void NEO_writeHue(uint16_t pixel, uint8_t hue, uint8_t bright);
+void NEO_clearPixel(uint16_t pixel);
 
 #ifdef __cplusplus
 };
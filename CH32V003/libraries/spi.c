@@ -1,5 +1,5 @@
 // ===================================================================================
-// Basic SPI Master Functions for CH32V003                                    * v1.0 *
+// Basic SPI Master Functions with DMA Buffer Transfers for CH32V003          * v1.1 *
 // ===================================================================================
 // 2023 by Stefan Wagner:   https://github.com/wagiminator
 
@@ -21,6 +21,20 @@ void SPI_init(void) {
               | SPI_CTLR1_SSM         // software control of NSS
               | SPI_CTLR1_SSI         // set internal NSS high
               | SPI_CTLR1_SPE;        // enable SPI
+
+  #if SPI_DMA > 0
+  // Setup DMA Channel 2 (RX)
+  RCC->AHBPCENR |= RCC_DMA1EN;                    // enable DMA module clock
+  DMA1_Channel2->PADDR = (uint32_t)&SPI1->DATAR;  // peripheral address
+  DMA1_Channel2->CFGR  = DMA_CFGR1_PL_1           // high priority (no RX overrun)
+                       | DMA_CFGR1_TCIE;          // transfer complete interrupt enable
+
+  // Setup DMA Channel 3 (TX)
+  DMA1_Channel3->PADDR = (uint32_t)&SPI1->DATAR;  // peripheral address
+  DMA1_Channel3->CFGR  = DMA_CFGR1_DIR;           // memory to SPI
+  DMA1->INTFCR         = DMA_CGIF2 | DMA_CGIF3;   // clear interrupt flags
+  NVIC_EnableIRQ(DMA1_Channel2_IRQn);             // enable the DMA RX IRQ
+  #endif
 }
 
 // Transfer one data byte (read and write)
@@ -29,3 +43,76 @@ uint8_t SPI_transfer(uint8_t data) {
   while(!SPI_available());            // wait for reply
   return SPI1->DATAR;                 // return received data byte
 }
+
+// ===================================================================================
+// DMA Buffer Transfers
+// ===================================================================================
+#if SPI_DMA > 0
+
+void (*SPI_DMA_callback)(void) = 0;   // function called after DMA transfer
+static uint8_t SPI_DMA_value;         // source of repeated TX byte
+static uint8_t SPI_DMA_dummy;         // sink of discarded RX bytes
+
+// Start DMA transfer; transfer is completed, when the last byte has been received
+static void SPI_DMA_start(const uint8_t* tx, uint8_t* rx, uint16_t len) {
+  SPI_DMA_wait();                                 // wait for previous transfer
+  while(SPI_busy());                              // wait for byte-wise transfers
+  while(SPI_available()) (void)SPI1->DATAR;       // discard old received data
+
+  // Setup RX channel
+  if(rx) {
+    DMA1_Channel2->MADDR = (uint32_t)rx;          // receive buffer
+    DMA1_Channel2->CFGR |=  DMA_CFGR1_MINC;       // increment memory address
+  }
+  else {
+    DMA1_Channel2->MADDR = (uint32_t)&SPI_DMA_dummy;
+    DMA1_Channel2->CFGR &= ~DMA_CFGR1_MINC;       // discard received data
+  }
+  DMA1_Channel2->CNTR = len;
+
+  // Setup TX channel
+  if(tx) {
+    DMA1_Channel3->MADDR = (uint32_t)tx;          // transmit buffer
+    DMA1_Channel3->CFGR |=  DMA_CFGR1_MINC;       // increment memory address
+  }
+  else {
+    DMA1_Channel3->MADDR = (uint32_t)&SPI_DMA_value;
+    DMA1_Channel3->CFGR &= ~DMA_CFGR1_MINC;       // repeat single value
+  }
+  DMA1_Channel3->CNTR = len;
+
+  // Start transfer (RX first, so no byte gets lost)
+  DMA1_Channel2->CFGR |= DMA_CFGR1_EN;
+  DMA1_Channel3->CFGR |= DMA_CFGR1_EN;
+  SPI1->CTLR2 |= SPI_CTLR2_RXDMAEN | SPI_CTLR2_TXDMAEN;
+}
+
+// Transmit and receive buffers via DMA (tx and/or rx may be NULL)
+void SPI_transferBuffer(const uint8_t* tx, uint8_t* rx, uint16_t len) {
+  if(!len) return;
+  if(!tx) {
+    SPI_DMA_wait();
+    SPI_DMA_value = 0x00;
+  }
+  SPI_DMA_start(tx, rx, len);
+}
+
+// Transmit one data byte repeatedly via DMA
+void SPI_fill(uint8_t data, uint16_t len) {
+  if(!len) return;
+  SPI_DMA_wait();
+  SPI_DMA_value = data;
+  SPI_DMA_start(0, 0, len);
+}
+
+// DMA RX complete: all bytes transmitted and received
+void DMA1_Channel2_IRQHandler(void) __attribute__((interrupt));
+void DMA1_Channel2_IRQHandler(void) {
+  SPI1->CTLR2 &= ~(SPI_CTLR2_RXDMAEN | SPI_CTLR2_TXDMAEN);  // disable DMA requests
+  DMA1_Channel3->CFGR &= ~DMA_CFGR1_EN;           // disable DMA channels
+  DMA1_Channel2->CFGR &= ~DMA_CFGR1_EN;
+  DMA1->INTFCR = DMA_CGIF2 | DMA_CGIF3;           // clear interrupt flags
+  if(SPI_DMA_callback) SPI_DMA_callback();        // call user function
+}
+
+#endif  // SPI_DMA > 0
@@ -1,5 +1,5 @@
 // ===================================================================================
-// Basic SPI Master Functions for CH32V003                                    * v1.0 *
+// Basic SPI Master Functions with DMA Buffer Transfers for CH32V003          * v1.1 *
 // ===================================================================================
 //
 // Functions available:
@@ -15,6 +15,24 @@
 // SPI_setBAUD(n)           Set BAUD rate (see below)
 // SPI_setCPOL(n)           0: SCK low in idle, 1: SCK high in idle
 // SPI_setCPHA(n)           Start sampling from 0: first clock edge, 1: second clock edge
+//
+// If DMA buffer transfers are activated (SPI_DMA = 1, see below):
+// ---------------------------------------------------------------
+// SPI_transferBuffer(t,r,n)  Transmit buffer (t) and receive into buffer (r) with
+//                          length (n) via DMA. If t is NULL, 0x00 is transmitted;
+//                          if r is NULL, received data is discarded.
+// SPI_writeBuffer(t,n)     Transmit buffer (t) with length (n) via DMA
+// SPI_readBuffer(r,n)      Receive (n) bytes into buffer (r) via DMA
+// SPI_fill(d,n)            Transmit data byte (d) (n) times via DMA
+// SPI_DMA_busy()           Check if a DMA transfer is in progress
+// SPI_DMA_wait()           Wait for DMA transfer to be completed
+// SPI_DMA_setCallback(f)   Set function f(), which is called from the DMA interrupt
+//                          after a transfer has been completed (0: none)
+//
+// The DMA functions start the transfer and return immediately, the buffers must not
+// be changed until the transfer is completed. A new transfer waits for the previous
+// one. SPI_transfer() must not be used while a DMA transfer is in progress. Use
+// SPI_DMA_wait() before releasing the slave select pin.
 
 // SPI pin mapping:
 // ----------------
@@ -24,6 +42,7 @@
 //
 // Slave select pins (NSS) must be defined and controlled by the application.
 // SPI clock rate must be defined below.
+// DMA uses channel 2 (SPI1 RX) and channel 3 (SPI1 TX).
 //
 // 2023 by Stefan Wagner:   https://github.com/wagiminator
 
@@ -37,6 +56,7 @@ extern "C" {
 
 // SPI Parameters
 #define SPI_PRESC           5     // SPI_CLKRATE = F_CPU / (2 << SPI_PRESC)
+#define SPI_DMA             0     // 1: enable DMA buffer transfers (needs vector table)
 
 // I2C Functions and Macros
 #define SPI_busy()          (SPI1->STATR & SPI_STATR_BSY)
@@ -52,6 +72,27 @@ extern "C" {
 void SPI_init(void);
 uint8_t SPI_transfer(uint8_t data);
 
+// DMA buffer transfers (if activated, see above)
+#if SPI_DMA > 0
+
+// Interrupt enable check
+#if SYS_USE_VECTORS == 0
+  #error Interrupt vector table must be enabled (SYS_USE_VECTORS in system.h)!
+#endif
+
+#define SPI_DMA_busy()          (DMA1_Channel2->CFGR & DMA_CFGR1_EN)  // DMA in progress
+#define SPI_DMA_wait()          while(SPI_DMA_busy())                 // wait for DMA
+#define SPI_DMA_setCallback(f)  SPI_DMA_callback = (f)                // set callback
+#define SPI_writeBuffer(t,n)    SPI_transferBuffer((t), 0, (n))
+#define SPI_readBuffer(r,n)     SPI_transferBuffer(0, (r), (n))
+
+extern void (*SPI_DMA_callback)(void);
+
+void SPI_transferBuffer(const uint8_t* tx, uint8_t* rx, uint16_t len);
+void SPI_fill(uint8_t data, uint16_t len);
+
+#endif  // SPI_DMA > 0
+
 #ifdef __cplusplus
 };
 #endif
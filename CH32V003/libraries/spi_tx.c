@@ -1,5 +1,5 @@
 // ===================================================================================
-// Basic SPI Master Functions (TX only) for CH32V003                          * v1.0 *
+// Basic SPI Master Functions (TX only) with DMA for CH32V003                 * v1.1 *
 // ===================================================================================
 // 2023 by Stefan Wagner:   https://github.com/wagiminator
 
@@ -22,10 +22,83 @@ void SPI_init(void) {
               | SPI_CTLR1_SSM         // software control of NSS
               | SPI_CTLR1_SSI         // set internal NSS high
               | SPI_CTLR1_SPE;        // enable SPI
+
+  #if SPI_DMA > 0
+  // Setup DMA Channel 3
+  RCC->AHBPCENR |= RCC_DMA1EN;                    // enable DMA module clock
+  DMA1_Channel3->PADDR = (uint32_t)&SPI1->DATAR;  // peripheral address
+  #endif
 }
 
 // Transmit one data byte
 void SPI_write(uint8_t data) {
+  #if SPI_DMA > 0
+  if(DMA1_Channel3->CFGR & DMA_CFGR3_EN) SPI_DMA_wait();
+  #endif
   while(!SPI_ready());                // wait for ready to write
   SPI1->DATAR = data;                 // send data byte
 }
+
+// ===================================================================================
+// DMA Transfers
+// ===================================================================================
+#if SPI_DMA > 0
+
+static uint16_t SPI_DMA_value;        // source of repeated data (8-bit: low byte)
+
+// Wait for DMA transfer to be completed, switch back to 8-bit frames
+void SPI_DMA_wait(void) {
+  while(DMA1_Channel3->CNTR);         // wait for all data moved to SPI
+  while(!SPI_ready());                // wait for last data moved to shift register
+  while(SPI_busy());                  // wait for last data shifted out
+  DMA1_Channel3->CFGR &= ~DMA_CFGR3_EN;           // disable DMA channel
+  SPI1->CTLR2         &= ~SPI_CTLR2_TXDMAEN;      // disable DMA request
+  if(SPI1->CTLR1 & SPI_CTLR1_DFF) {               // 16-bit frames?
+    SPI_disable();                                // -> frame format can only be
+    SPI1->CTLR1 &= ~SPI_CTLR1_DFF;                //    changed while SPI is disabled
+    SPI_enable();
+  }
+}
+
+// Start DMA transfer with channel configuration
+static void SPI_DMA_start(const void* buf, uint16_t len, uint16_t cfg) {
+  if(cfg & DMA_CFGR3_PSIZE_0) {                   // 16-bit frames?
+    SPI_disable();
+    SPI1->CTLR1 |= SPI_CTLR1_DFF;
+    SPI_enable();
+  }
+  DMA1_Channel3->MADDR = (uint32_t)buf;           // memory address
+  DMA1_Channel3->CNTR  = len;                     // number of frames to be transfered
+  DMA1_Channel3->CFGR  = cfg                      // transfer configuration
+                       | DMA_CFGR3_DIR            // memory to SPI
+                       | DMA_CFGR3_EN;            // enable DMA channel
+  SPI1->CTLR2         |= SPI_CTLR2_TXDMAEN;       // enable DMA request -> start
+}
+
+// Transmit buffer via DMA
+void SPI_writeBuffer(const uint8_t* buf, uint16_t len) {
+  SPI_DMA_wait();
+  if(len) SPI_DMA_start(buf, len, DMA_CFGR3_MINC);
+}
+
+// Transmit buffer of 16-bit words via DMA
+void SPI_writeBuffer16(const uint16_t* buf, uint16_t len) {
+  SPI_DMA_wait();
+  if(len) SPI_DMA_start(buf, len, DMA_CFGR3_MINC | DMA_CFGR3_PSIZE_0 | DMA_CFGR3_MSIZE_0);
+}
+
+// Transmit data byte repeatedly via DMA
+void SPI_fill(uint8_t data, uint16_t len) {
+  SPI_DMA_wait();
+  SPI_DMA_value = data;
+  if(len) SPI_DMA_start(&SPI_DMA_value, len, 0);
+}
+
+// Transmit 16-bit word repeatedly via DMA
+void SPI_fill16(uint16_t data, uint16_t len) {
+  SPI_DMA_wait();
+  SPI_DMA_value = data;
+  if(len) SPI_DMA_start(&SPI_DMA_value, len, DMA_CFGR3_PSIZE_0 | DMA_CFGR3_MSIZE_0);
+}
+
+#endif  // SPI_DMA > 0
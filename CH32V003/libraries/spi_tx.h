@@ -1,5 +1,5 @@
 // ===================================================================================
-// Basic SPI Master Functions (TX only) for CH32V003                          * v1.0 *
+// Basic SPI Master Functions (TX only) with DMA for CH32V003                 * v1.1 *
 // ===================================================================================
 //
 // Functions available:
@@ -14,6 +14,20 @@
 // SPI_setBAUD(n)           Set BAUD rate (see below)
 // SPI_setCPOL(n)           0: SCK low in idle, 1: SCK high in idle
 // SPI_setCPHA(n)           Start sampling from 0: first clock edge, 1: second clock edge
+//
+// If DMA transfers are activated (SPI_DMA = 1, see below):
+// --------------------------------------------------------
+// SPI_writeBuffer(b,n)     Transmit buffer (b) with (n) bytes via DMA
+// SPI_writeBuffer16(b,n)   Transmit buffer (b) with (n) 16-bit words (MSB first) via DMA
+// SPI_fill(d,n)            Transmit data byte (d) (n) times via DMA
+// SPI_fill16(d,n)          Transmit 16-bit word (d) (n) times (MSB first) via DMA
+// SPI_DMA_busy()           Check if a DMA transfer is in progress
+// SPI_DMA_wait()           Wait for DMA transfer to be completed
+//
+// The DMA functions start the transfer and return immediately, the buffer must not
+// be changed until the transfer is completed. The next SPI function waits for the
+// transfer to be completed, no interrupt is used. The 16-bit functions switch SPI to
+// 16-bit frames, SPI_DMA_wait() switches back to 8-bit.
 
 // SPI pin mapping:
 // ----------------
@@ -22,6 +36,7 @@
 //
 // Slave select pins (NSS) must be defined and controlled by the application.
 // SPI clock rate must be defined below.
+// DMA uses channel 3 (SPI1 TX).
 //
 // 2023 by Stefan Wagner:   https://github.com/wagiminator
 
@@ -35,6 +50,7 @@ extern "C" {
 
 // SPI Parameters
 #define SPI_PRESC           5     // SPI_CLKRATE = F_CPU / (2 << SPI_PRESC + 1)
+#define SPI_DMA             0     // 1: enable DMA transfers
 
 // I2C Functions and Macros
 #define SPI_busy()          (SPI1->STATR & SPI_STATR_BSY)
@@ -49,6 +65,19 @@ extern "C" {
 void SPI_init(void);
 void SPI_write(uint8_t data);
 
+// DMA transfers (if activated, see above)
+#if SPI_DMA > 0
+
+#define SPI_DMA_busy()      (DMA1_Channel3->CNTR || SPI_busy())
+
+void SPI_DMA_wait(void);
+void SPI_writeBuffer(const uint8_t* buf, uint16_t len);
+void SPI_writeBuffer16(const uint16_t* buf, uint16_t len);
+void SPI_fill(uint8_t data, uint16_t len);
+void SPI_fill16(uint16_t data, uint16_t len);
+
+#endif  // SPI_DMA > 0
+
 #ifdef __cplusplus
 };
 #endif
@@ -1,5 +1,5 @@
 // ===================================================================================
-// UART with DMA RX Buffer for CH32V003                                       * v1.1 *
+// UART with DMA RX Buffer and DMA TX Queue for CH32V003                     * v1.4 *
 // ===================================================================================
 // 2023 by Stefan Wagner:   https://github.com/wagiminator
 
@@ -10,6 +10,26 @@ char UART_RX_buffer[UART_RX_BUF_SIZE];
 uint8_t UART_RX_tptr = 0;
 #define UART_RX_hptr (UART_RX_BUF_SIZE - DMA1_Channel5->CNTR)
 
+// Check queue size
+#if (UART_TX_QUEUE_SIZE & (UART_TX_QUEUE_SIZE - 1)) || (UART_TX_QUEUE_SIZE < 2)
+  #error UART_TX_QUEUE_SIZE must be a power of 2!
+#endif
+
+// TX DMA queue (descriptors of buffers to be sent)
+typedef struct {
+  const char* buf;                          // pointer to buffer
+  uint16_t    len;                          // number of bytes
+} UART_TX_DESCR_TYPE;
+
+UART_TX_DESCR_TYPE UART_TX_queue[UART_TX_QUEUE_SIZE];
+volatile uint8_t UART_TX_head = 0;          // next free slot
+volatile uint8_t UART_TX_tail = 0;          // buffer currently sent
+void (*UART_TX_callback)(const char* buf, uint16_t len) = 0;
+
+// Linear TX buffer for UART_writeBuffer
+char UART_TX_buffer[UART_TX_BUF_SIZE];
+volatile uint8_t UART_TX_bufBusy = 0;       // TX buffer queued but not yet sent
+
 // Init UART
 void UART_init(void) {
 #if UART_MAP == 0
@@ -57,7 +77,7 @@ void UART_init(void) {
 	
   // Setup and start UART (8N1, RX/TX, default BAUD rate)
   USART1->BRR    = ((2 * F_CPU / UART_BAUD) + 1) / 2;
-  USART1->CTLR3 |= USART_CTLR3_DMAR;
+  USART1->CTLR3 |= USART_CTLR3_DMAR | USART_CTLR3_DMAT;
   USART1->CTLR1  = USART_CTLR1_RE | USART_CTLR1_TE | USART_CTLR1_UE;
 
   // Setup DMA Channel 5
@@ -68,6 +88,14 @@ void UART_init(void) {
   DMA1_Channel5->CFGR  = DMA_CFGR1_MINC       // increment memory address
                        | DMA_CFGR1_CIRC       // circular mode
                        | DMA_CFGR1_EN;        // enable
+
+  // Setup DMA Channel 4
+  DMA1_Channel4->PADDR = (uint32_t)&USART1->DATAR;
+  DMA1_Channel4->CFGR  = DMA_CFGR1_MINC       // increment memory address
+                       | DMA_CFGR1_DIR        // memory to peripheral
+                       | DMA_CFGR1_TCIE;      // transfer complete interrupt enable
+  DMA1->INTFCR         = DMA_CGIF4;           // clear interrupt flags
+  NVIC_EnableIRQ(DMA1_Channel4_IRQn);         // enable the DMA IRQ
 }
 
 // Check if something is in the RX buffer
@@ -84,8 +112,75 @@ char UART_read(void) {
   return result;
 }
 
+// Get pointer to longest contiguous readable span in RX buffer, return its length
+uint16_t UART_peek(const char** ptr) {
+  uint16_t hptr = UART_RX_hptr;
+  *ptr = UART_RX_buffer + UART_RX_tptr;
+  if(hptr >= UART_RX_tptr) return(hptr - UART_RX_tptr);
+  return(UART_RX_BUF_SIZE - UART_RX_tptr);
+}
+
+// Remove n bytes from RX buffer
+void UART_consume(uint16_t n) {
+  n += UART_RX_tptr;
+  if(n >= UART_RX_BUF_SIZE) n -= UART_RX_BUF_SIZE;
+  UART_RX_tptr = n;
+}
+
 // Send byte via UART
 void UART_write(const char c) {
-  while(!UART_ready());
+  while(UART_TX_busy() || !UART_ready());
   USART1->DATAR = c;
 }
+
+// Start DMA transfer of the buffer at the tail of the queue
+static inline void UART_TX_start(void) {
+  DMA1_Channel4->CFGR &= ~DMA_CFGR1_EN;       // disable DMA channel
+  DMA1_Channel4->MADDR = (uint32_t)UART_TX_queue[UART_TX_tail].buf;
+  DMA1_Channel4->CNTR  = UART_TX_queue[UART_TX_tail].len;
+  DMA1_Channel4->CFGR |= DMA_CFGR1_EN;        // start transfer
+}
+
+// Queue buffer for DMA transfer (not copied), returns 0 if queue is full
+uint8_t UART_send(const char* buf, uint16_t len) {
+  if(!len) return 1;                          // nothing to send
+  INT_ATOMIC_BLOCK {
+    if(UART_TX_full()) len = 0;               // queue full -> reject
+    else {
+      UART_TX_queue[UART_TX_head].buf = buf;  // fill descriptor
+      UART_TX_queue[UART_TX_head].len = len;
+      uint8_t idle = !UART_TX_busy();         // queue empty before?
+      UART_TX_head = (UART_TX_head + 1) & (UART_TX_QUEUE_SIZE - 1);
+      if(idle) UART_TX_start();               // -> start transfer now
+    }
+  }
+  return(len > 0);
+}
+
+// Send buffer via UART using DMA (data is copied into the TX buffer, returns as soon
+// as the last block has been queued)
+void UART_writeBuffer(const char* buf, uint16_t len) {
+  uint16_t i, cnt;
+  while(len) {
+    cnt = (len < UART_TX_BUF_SIZE) ? len : UART_TX_BUF_SIZE;
+    while(UART_TX_bufBusy);                   // wait for TX buffer
+    for(i=0; i<cnt; i++) UART_TX_buffer[i] = *buf++;
+    UART_TX_bufBusy = 1;
+    while(!UART_send(UART_TX_buffer, cnt));   // queue TX buffer (retry if queue full)
+    len -= cnt;
+  }
+}
+
+// Interrupt service routine (transfer complete -> chain next queued buffer)
+void DMA1_Channel4_IRQHandler(void) __attribute__((interrupt));
+void DMA1_Channel4_IRQHandler(void) {
+  UART_TX_DESCR_TYPE* done = &UART_TX_queue[UART_TX_tail];
+  const char* buf = done->buf;                // remember completed buffer
+  uint16_t    len = done->len;
+  DMA1->INTFCR = DMA_CGIF4;                   // clear interrupt flags
+  DMA1_Channel4->CFGR &= ~DMA_CFGR1_EN;       // disable DMA channel
+  UART_TX_tail = (UART_TX_tail + 1) & (UART_TX_QUEUE_SIZE - 1);
+  if(UART_TX_busy()) UART_TX_start();         // start next queued buffer
+  if(buf == UART_TX_buffer) UART_TX_bufBusy = 0; // TX buffer can be reused
+  else if(UART_TX_callback) UART_TX_callback(buf, len);
+}
@@ -1,5 +1,5 @@
 // ===================================================================================
-// UART with DMA RX Buffer for CH32V003                                       * v1.1 *
+// UART with DMA RX Buffer and DMA TX Queue for CH32V003                     * v1.4 *
 // ===================================================================================
 //
 // Functions available:
@@ -15,9 +15,22 @@
 // UART_ready()             Check if UART is ready to write
 // UART_available()         Check if there is something to read
 // UART_completed()         Check if transmission is completed
+// UART_TX_busy()           Check if a DMA transmission is in progress
+// UART_TX_full()           Check if DMA TX queue is full
 //
 // UART_read()              Read character via UART
+// UART_peek(&p)            Get pointer (p) to contiguous received data, returns length
+// UART_consume(n)          Remove n bytes from RX buffer (after UART_peek)
 // UART_write(c)            Send character via UART
+// UART_writeBuffer(b,n)    Copy buffer (b) with length (n) and send it via DMA
+// UART_send(b,n)           Queue buffer (b) with length (n) for DMA transfer without
+//                          copying, returns immediately (0 if queue is full). The
+//                          buffer must not be changed until the transfer is completed.
+// UART_TX_setCallback(f)   Set function f(buf, len), which is called from the DMA
+//                          interrupt after a queued buffer has been sent (0: none)
+//
+// Queued buffers are sent back-to-back, the next transfer is chained directly from
+// the DMA transfer complete interrupt. The callback may queue further buffers.
 //
 // UART_enable()            Enable USART
 // UART_disable()           Disable USART
@@ -28,7 +41,8 @@
 //
 // If print functions are activated (see below, print.h must be included):
 // -----------------------------------------------------------------------
-// UART_printf(f, ...)      printf (supports %s, %c, %d, %u, %x, %b, %02d, %%)
+// UART_printf(f, ...)      printf (supports %s, %c, %d, %u, %x, %b, %02d, %%),
+//                          sends the formatted string as blocks via DMA
 // UART_printD(n)           Print decimal value
 // UART_printW(n)           Print 32-bit hex word value
 // UART_printH(n)           Print 16-bit hex half-word value
@@ -58,11 +72,16 @@ extern "C" {
 #define UART_BAUD             115200      // default UART baud rate
 #define UART_MAP              0           // UART pin mapping (see above)
 #define UART_RX_BUF_SIZE      64          // UART RX buffer size
+#define UART_TX_BUF_SIZE      64          // UART TX buffer size for UART_writeBuffer
+#define UART_TX_QUEUE_SIZE    4           // UART TX DMA queue size (must be power of 2)
 #define UART_PRINT            0           // 1: include print functions (needs print.h)
 
 // UART Macros
 #define UART_ready()          (USART1->STATR & USART_STATR_TXE)   // ready to write
 #define UART_completed()      (USART1->STATR & USART_STATR_TC)    // transmission completed
+#define UART_TX_busy()        (UART_TX_head != UART_TX_tail)      // DMA TX in progress
+#define UART_TX_full()        (((UART_TX_head + 1) & (UART_TX_QUEUE_SIZE - 1)) == UART_TX_tail)
+#define UART_TX_setCallback(f) UART_TX_callback = (f)             // set TX callback
 
 #define UART_enable()         USART1->CTLR1 |= USART_CTLR1_UE     // enable USART
 #define UART_disable()        USART1->CTLR1 &= ~USART_CTLR1_UE    // disable USART
@@ -78,11 +97,25 @@ extern "C" {
 #define UART_setOddParity()   {USART1->CTLR1 |= USART_CTLR1_PCE; USART1->CTLR1 |=  USART_CTLR1_PS;}
 #define UART_setNoParity()    USART1->CTLR1 &= ~USART_CTLR1_PCE
 
+// Interrupt enable check
+#if SYS_USE_VECTORS == 0
+  #error Interrupt vector table must be enabled (SYS_USE_VECTORS in system.h)!
+#endif
+
+// UART Variables
+extern volatile uint8_t UART_TX_head;     // TX queue: next free slot
+extern volatile uint8_t UART_TX_tail;     // TX queue: buffer currently sent
+extern void (*UART_TX_callback)(const char* buf, uint16_t len);
+
 // UART Functions
 void UART_init(void);                     // init UART with default BAUD rate
 void UART_write(const char c);            // send character via UART
+void UART_writeBuffer(const char* buf, uint16_t len); // copy and send buffer via DMA
+uint8_t UART_send(const char* buf, uint16_t len);     // queue buffer for DMA transfer
 char UART_read(void);                     // read character via UART
 uint8_t UART_available(void);             // check if there is something to read
+uint16_t UART_peek(const char** ptr);     // get contiguous readable span
+void UART_consume(uint16_t n);            // remove n bytes from RX buffer
 
 // Additional print functions (if activated, see above)
 #if UART_PRINT == 1
@@ -95,7 +128,7 @@ uint8_t UART_available(void);             // check if there is something to read
 #define UART_println(s)       println(UART_write, s)  // print string with newline
 #define UART_print            UART_printS             // alias
 #define UART_newline()        UART_write('\n')        // send newline
-#define UART_printf(f, ...)   printF(UART_write, f, ##__VA_ARGS__)
+#define UART_printf(f, ...)   printFB(UART_writeBuffer, f, ##__VA_ARGS__)
 #endif
 
 #ifdef __cplusplus
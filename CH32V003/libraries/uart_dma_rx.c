@@ -1,5 +1,5 @@
 // ===================================================================================
-// UART with DMA (RX only) for CH32V003                                       * v1.1 *
+// UART with DMA (RX only) for CH32V003                                       * v1.3 *
 // ===================================================================================
 // 2023 by Stefan Wagner:   https://github.com/wagiminator
 
@@ -7,7 +7,8 @@
 
 // Circular RX buffer
 char UART_RX_buffer[UART_RX_BUF_SIZE];
-uint8_t UART_RX_tptr = 0;
+uint16_t UART_RX_tptr = 0;
+void (*UART_RX_callback)(const char* buf, uint16_t len) = 0;
 #define UART_RX_hptr (UART_RX_BUF_SIZE - DMA1_Channel5->CNTR)
 
 // Init UART
@@ -63,7 +64,19 @@ void UART_init(void) {
   DMA1_Channel5->PADDR = (uint32_t)&USART1->DATAR;
   DMA1_Channel5->CFGR  = DMA_CFGR1_MINC       // increment memory address
                        | DMA_CFGR1_CIRC       // circular mode
+                       #if UART_RX_EVENT > 0
+                       | DMA_CFGR1_HTIE       // half transfer interrupt enable
+                       | DMA_CFGR1_TCIE       // transfer complete interrupt enable
+                       #endif
                        | DMA_CFGR1_EN;        // enable
+
+  // Setup interrupts for event-driven receive
+  #if UART_RX_EVENT > 0
+  DMA1->INTFCR   = DMA_CGIF5;                 // clear DMA interrupt flags
+  USART1->CTLR1 |= USART_CTLR1_IDLEIE;        // enable IDLE line interrupt
+  NVIC_EnableIRQ(DMA1_Channel5_IRQn);         // enable the DMA IRQ
+  NVIC_EnableIRQ(USART1_IRQn);                // enable the USART IRQ
+  #endif
 }
 
 // Check if something is in the RX buffer
@@ -79,3 +92,57 @@ char UART_read(void) {
   if(UART_RX_tptr >= UART_RX_BUF_SIZE) UART_RX_tptr = 0;
   return result;
 }
+
+// Get pointer to longest contiguous readable span in RX buffer, return its length
+uint16_t UART_peek(const char** ptr) {
+  uint16_t hptr = UART_RX_hptr;
+  *ptr = UART_RX_buffer + UART_RX_tptr;
+  if(hptr >= UART_RX_tptr) return(hptr - UART_RX_tptr);
+  return(UART_RX_BUF_SIZE - UART_RX_tptr);
+}
+
+// Remove n bytes from RX buffer
+void UART_consume(uint16_t n) {
+  n += UART_RX_tptr;
+  if(n >= UART_RX_BUF_SIZE) n -= UART_RX_BUF_SIZE;
+  UART_RX_tptr = n;
+}
+
+// ===================================================================================
+// Event-Driven Receive
+// ===================================================================================
+#if UART_RX_EVENT > 0
+
+// Hand all new data in the ring buffer over to the callback function
+static void UART_RX_process(void) {
+  uint16_t hptr = UART_RX_hptr;               // get current DMA position
+  if(hptr == UART_RX_BUF_SIZE) hptr = 0;      // (can be reached before reload)
+  if(hptr == UART_RX_tptr) return;            // nothing new
+  if(UART_RX_callback) {
+    if(hptr > UART_RX_tptr)                   // contiguous chunk?
+      UART_RX_callback(UART_RX_buffer + UART_RX_tptr, hptr - UART_RX_tptr);
+    else {                                    // wrap around end of ring?
+      UART_RX_callback(UART_RX_buffer + UART_RX_tptr, UART_RX_BUF_SIZE - UART_RX_tptr);
+      if(hptr) UART_RX_callback(UART_RX_buffer, hptr);
+    }
+  }
+  UART_RX_tptr = hptr;                        // data consumed
+}
+
+// DMA interrupt service routine (half-transfer and transfer-complete)
+void DMA1_Channel5_IRQHandler(void) __attribute__((interrupt));
+void DMA1_Channel5_IRQHandler(void) {
+  DMA1->INTFCR = DMA_CGIF5;                   // clear interrupt flags
+  UART_RX_process();                          // process received data
+}
+
+// USART interrupt service routine (IDLE line detected)
+void USART1_IRQHandler(void) __attribute__((interrupt));
+void USART1_IRQHandler(void) {
+  if(USART1->STATR & USART_STATR_IDLE) {      // IDLE line detected?
+    (void)USART1->DATAR;                      // clear IDLE flag (STATR then DATAR)
+    UART_RX_process();                        // process received data
+  }
+}
+
+#endif // UART_RX_EVENT > 0
@@ -1,5 +1,5 @@
 // ===================================================================================
-// UART with DMA (RX only) for CH32V003                                       * v1.1 *
+// UART with DMA (RX only) for CH32V003                                       * v1.3 *
 // ===================================================================================
 //
 // Functions available:
@@ -7,6 +7,18 @@
 // UART_init()              Init UART with default BAUD rate (115200)
 // UART_available()         Check if there is something to read
 // UART_read()              Read character via UART
+// UART_peek(&p)            Get pointer (p) to contiguous received data, returns length
+// UART_consume(n)          Remove n bytes from RX buffer (after UART_peek)
+//
+// If event-driven receive is activated (see below, UART_RX_EVENT):
+// ----------------------------------------------------------------
+// UART_RX_setCallback(f)   Set function f(buf, len), which is called from interrupt
+//                          with each received chunk. A chunk is delivered on IDLE
+//                          line detection, DMA half-transfer and transfer-complete.
+//                          The data is not copied, it points directly into the DMA
+//                          ring buffer and stays valid for at least half the ring.
+//                          If the received data wraps around the end of the ring, the
+//                          callback is called twice. Don't use UART_read() then.
 //
 // UART_setBaud(n)          Set BAUD rate
 // UART_setStopBits(n)      Set number of stop bits (n = 1, 2)
@@ -36,11 +48,23 @@ extern "C" {
 #define UART_BAUD             115200      // default UART baud rate
 #define UART_MAP              0           // UART pin remapping (see above)
 #define UART_RX_BUF_SIZE      64          // UART RX buffer size
+#define UART_RX_EVENT         0           // 1: deliver received chunks to callback
+
+// Interrupt enable check
+#if UART_RX_EVENT > 0 && SYS_USE_VECTORS == 0
+  #error Interrupt vector table must be enabled (SYS_USE_VECTORS in system.h)!
+#endif
 
 // UART Functions
 void UART_init(void);                     // init UART with default BAUD rate
 char UART_read(void);                     // read character via UART
 uint8_t UART_available(void);             // check if there is something to read
+uint16_t UART_peek(const char** ptr);     // get contiguous readable span
+void UART_consume(uint16_t n);            // remove n bytes from RX buffer
+
+// UART Event Callback
+extern void (*UART_RX_callback)(const char* buf, uint16_t len);
+#define UART_RX_setCallback(f) UART_RX_callback = (f)             // set RX callback
 
 // UART Macros
 #define UART_setBAUD(n)       USART1->BRR = ((2*F_CPU/(n))+1)/2;  // set BAUD rate
@@ -0,0 +1,200 @@
+#!/usr/bin/env python3
+# ===================================================================================
+# Project:   tracedec - Decoder for Binary DEBUG Trace Records
+# Version:   v1.0
+# Year:      2023
+# Author:    Stefan Wagner
+# Github:    https://github.com/wagiminator
+# License:   MIT License
+# ===================================================================================
+#
+# Description:
+# ------------
+# Rebuilds the text of binary trace records sent by DEBUG_trace() (debug_serial.c
+# with DEBUG_TRACE = 1). The format strings are read from the ".trace" section of
+# the ELF file, arguments for %s are looked up in the loadable sections.
+#
+# Record format (little-endian):
+# 0xA5 | number of args (n) | ID (16 bits) | timestamp (32 bits) | n x arg (32 bits)
+#
+# Dependencies:
+# -------------
+# - pyserial (only for reading from a serial port)
+#
+# Operating Instructions:
+# -----------------------
+# Build the firmware with "make all" so that bin/firmware.elf is kept. Connect the
+# TX pin of the MCU to a USB-to-serial adapter and run:
+# "python3 tracedec.py bin/firmware.elf /dev/ttyUSB0"
+# A previously recorded binary file can be used instead of the serial port:
+# "python3 tracedec.py bin/firmware.elf capture.bin"
+# Options: -b <baud rate> (default 115200), -f <SysTick clock in Hz> (default 48000000)
+
+
+import struct
+import sys
+import os
+
+
+TRACE_SYNC   = 0xA5
+DEFAULT_BAUD = 115200
+DEFAULT_FCPU = 48000000
+
+
+# ===================================================================================
+# Main Function
+# ===================================================================================
+
+def _main():
+    args = sys.argv[1:]
+    baud = DEFAULT_BAUD
+    fcpu = DEFAULT_FCPU
+    try:
+        while '-b' in args:
+            i = args.index('-b'); baud = int(args[i+1]); del args[i:i+2]
+        while '-f' in args:
+            i = args.index('-f'); fcpu = int(args[i+1]); del args[i:i+2]
+    except (IndexError, ValueError):
+        args = []
+    if len(args) != 2:
+        sys.stderr.write('Usage: python3 tracedec.py [-b baud] [-f fcpu] firmware.elf <port|file>\n')
+        sys.exit(1)
+
+    try:
+        elf = ElfFile(args[0])
+        decoder = TraceDecoder(elf, fcpu)
+        stream = open_stream(args[1], baud)
+        for line in decoder.decode(stream):
+            print(line, flush=True)
+    except KeyboardInterrupt:
+        pass
+    except Exception as ex:
+        sys.stderr.write('ERROR: ' + str(ex) + '!\n')
+        sys.exit(1)
+    sys.exit(0)
+
+# Open serial port or binary file, return function which reads n bytes
+def open_stream(name, baud):
+    if os.path.isfile(name):
+        f = open(name, 'rb')
+        return f.read
+    import serial
+    port = serial.Serial(name, baud)
+    return port.read
+
+# ===================================================================================
+# ELF File Class (32-bit little-endian, section headers only)
+# ===================================================================================
+
+class ElfFile:
+    def __init__(self, filename):
+        with open(filename, 'rb') as f: self.data = f.read()
+        if self.data[:4] != b'\x7fELF' or self.data[4] != 1 or self.data[5] != 1:
+            raise Exception('Not a 32-bit little-endian ELF file')
+        shoff, = struct.unpack_from('<I', self.data, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from('<HHH', self.data, 0x2E)
+        headers = []
+        for i in range(shnum):
+            name, stype, flags, addr, offset, size = struct.unpack_from(
+                '<IIIIII', self.data, shoff + i * shentsize)
+            headers.append((name, stype, flags, addr, offset, size))
+        stroff = headers[shstrndx][4]
+        self.sections = {}
+        for name, stype, flags, addr, offset, size in headers:
+            sname = self.data[stroff + name:self.data.index(b'\0', stroff + name)].decode()
+            self.sections[sname] = (stype, flags, addr, offset, size)
+
+    # Get null-terminated string at offset within section
+    def string(self, section, addr):
+        if section not in self.sections:
+            raise Exception('Section ' + section + ' not found in ELF file')
+        stype, flags, start, offset, size = self.sections[section]
+        if not start <= addr < start + size:
+            return None
+        pos = offset + addr - start
+        return self.data[pos:self.data.index(b'\0', pos)].decode(errors='replace')
+
+    # Get null-terminated string at memory address (loadable sections only)
+    def string_at(self, addr):
+        for name, (stype, flags, start, offset, size) in self.sections.items():
+            if (flags & 2) and stype == 1 and start <= addr < start + size:
+                return self.string(name, addr)
+        return None
+
+# ===================================================================================
+# Trace Decoder Class
+# ===================================================================================
+
+class TraceDecoder:
+    def __init__(self, elf, fcpu):
+        self.elf  = elf
+        self.fcpu = fcpu
+        if '.trace' not in self.elf.sections:
+            raise Exception('No .trace section in ELF file (DEBUG_TRACE enabled?)')
+
+    # Read records from stream and yield decoded lines
+    def decode(self, read):
+        while True:
+            b = read(1)
+            if not b:
+                return
+            if b[0] != TRACE_SYNC:
+                continue                                # resynchronize
+            head = read(7)
+            if len(head) < 7:
+                return
+            argc, fid, time = struct.unpack('<BHI', head)
+            raw = read(argc * 4)
+            if len(raw) < argc * 4:
+                return
+            args = struct.unpack('<%dI' % argc, raw)
+            fmt  = self.elf.string('.trace', fid)
+            if fmt is None:
+                yield '[%10.6f] <unknown trace ID 0x%04X>' % (time / self.fcpu, fid)
+                continue
+            yield '[%10.6f] %s' % (time / self.fcpu, self.format(fmt, args).rstrip('\n'))
+
+    # Render format string (supports %s, %c, %d, %u, %x, %b, %02d, %%)
+    def format(self, fmt, args):
+        out  = ''
+        args = list(args)
+        i = 0
+        while i < len(fmt):
+            c = fmt[i]; i += 1
+            if c != '%':
+                out += c; continue
+            if i < len(fmt) and fmt[i] == '%':
+                out += '%'; i += 1; continue
+            pad = ' '
+            if i < len(fmt) and fmt[i] == '0':
+                pad = '0'; i += 1
+            width = 0
+            while i < len(fmt) and fmt[i].isdigit():
+                width = width * 10 + int(fmt[i]); i += 1
+            if i >= len(fmt):
+                break
+            conv = fmt[i]; i += 1
+            if conv not in 'scduxb':
+                out += conv; continue
+            val = args.pop(0) if args else 0
+            if conv == 's':
+                s = self.elf.string_at(val)
+                out += s if s is not None else '<0x%08X>' % val
+                continue
+            if conv == 'c':
+                out += chr(val & 0xFF); continue
+            sign = ''
+            if conv == 'd' and val & 0x80000000:
+                val = (1 << 32) - val; sign = '-'
+            digits = {'d': '%d', 'u': '%d', 'x': '%X'}.get(conv)
+            digits = digits % val if digits else bin(val)[2:]
+            if pad == '0':
+                out += sign + digits.rjust(width - len(sign), '0')
+            else:
+                out += (sign + digits).rjust(width)
+        return out
+
+# ===================================================================================
+
+if __name__ == "__main__":
+    _main()
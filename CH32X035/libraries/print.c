@@ -1,24 +1,47 @@
 // ===================================================================================
-// Basic PRINT Functions                                                      * v1.1 *
+// Basic PRINT Functions                                                      * v1.2 *
 // ===================================================================================
 // 2023 by Stefan Wagner:   https://github.com/wagiminator
 
 #include <stdarg.h>
 #include "print.h"
 
+// Decimal conversion: divide value by 10 and return the remainder. Cores without a
+// hardware divider (RV32EC, Cortex-M0/M0+) use a multiply-free shift-and-add
+// reciprocal instead of the slow division routines of libgcc.
+#if defined(__riscv_div) || defined(__ARM_FEATURE_IDIV)
+static inline uint8_t _divmod10(uint32_t* value) {
+  uint32_t q = *value / 10;
+  uint8_t  r = *value - q * 10;
+  *value = q;
+  return r;
+}
+#else
+static inline uint8_t _divmod10(uint32_t* value) {
+  uint32_t q, r;
+  q  = (*value >> 1) + (*value >> 2);       // q = value * 0.11b
+  q += q >> 4;                              // q = value * 0.110011b
+  q += q >> 8;                              // q = value * 0.11001100110011b
+  q += q >> 16;                             // q = value * 0.8 (rounded down)
+  q >>= 3;                                  // q = value / 10 (might be 1 too small)
+  r  = *value - (((q << 2) + q) << 1);      // r = value - q * 10
+  if(r > 9) {                               // correct estimation
+    q++;
+    r -= 10;
+  }
+  *value = q;
+  return r;
+}
+#endif
+
 // Print decimal value
 void printD(void (*putchar) (char c), uint32_t value) {
-  uint8_t digitval;                               // current digit value
-  uint8_t leadflag = 0;                           // flag for leading spaces
-  uint32_t divider = 1000000000;                  // current divider
-  while(divider) {                                // for all digits
-    digitval = value / divider;                   // calculate digit value
-    value    = value % divider;                   // set value to division remainder
-    divider /= 10;                                // calculate next divider
-    if(digitval) leadflag++;                      // end of leading spaces
-    if(!divider) leadflag++;                      // least digit has to be printed
-    if(leadflag) putchar(digitval + '0');         // print the digit
-  }
+  char s[10];                               // digit buffer
+  uint8_t i = 0;
+  do s[i++] = _divmod10(&value) + '0';      // convert digits, least significant first
+  while(value);
+  do putchar(s[--i]);                       // print digits, most significant first
+  while(i);
 }
 
 // Convert 4-bit byte nibble into hex character and print it via putchar
@@ -66,6 +89,52 @@ void printF(void (*putchar) (char c), const char *format, ...) {
   va_end(arg);
 }
 
+// Buffered printf: characters are collected in a buffer, which is either handed to
+// the write function as a block whenever it is full and at the end (printFB), or
+// simply truncated (sprintF). The write function must have consumed (sent or copied)
+// the data when it returns, because the staging buffer is reused afterwards.
+static char PRINT_buffer[PRINT_BUF_SIZE];               // staging buffer for printFB
+static char* PRINT_bufptr;                              // pointer to current buffer
+static uint16_t PRINT_bufsize;                          // size of current buffer
+static uint16_t PRINT_buflen;                           // number of chars in current buffer
+static void (*PRINT_write) (const char* buf, uint16_t len); // block write function
+
+// Put character into current buffer, hand full buffer over to write function
+static void _bputc(char c) {
+  if(PRINT_buflen >= PRINT_bufsize) {                   // buffer full?
+    if(!PRINT_write) return;                            // -> truncate if no write function
+    PRINT_write(PRINT_bufptr, PRINT_buflen);            // -> hand buffer over as a block
+    PRINT_buflen = 0;                                   // -> start again
+  }
+  PRINT_bufptr[PRINT_buflen++] = c;                     // put char into buffer
+}
+
+void printFB(void (*write) (const char* buf, uint16_t len), const char *format, ...) {
+  va_list arg;
+  PRINT_bufptr  = PRINT_buffer;
+  PRINT_bufsize = PRINT_BUF_SIZE;
+  PRINT_buflen  = 0;
+  PRINT_write   = write;
+  va_start(arg, format);
+  _vfprintf(_bputc, format, arg);
+  va_end(arg);
+  if(PRINT_buflen) write(PRINT_buffer, PRINT_buflen);
+}
+
+uint16_t sprintF(char* buf, uint16_t size, const char *format, ...) {
+  va_list arg;
+  if(!size) return 0;
+  PRINT_bufptr  = buf;
+  PRINT_bufsize = size - 1;                             // leave room for terminator
+  PRINT_buflen  = 0;
+  PRINT_write   = 0;
+  va_start(arg, format);
+  _vfprintf(_bputc, format, arg);
+  va_end(arg);
+  buf[PRINT_buflen] = 0;
+  return PRINT_buflen;
+}
+
 static void _vfprintf(void (*putchar) (char c), const char* str,  va_list arp) {
   int32_t d, r, w, s;
   char *c;
@@ -113,6 +182,7 @@ static void _vfprintf(void (*putchar) (char c), const char* str,  va_list arp) {
 
 void _itoa(void (*putchar) (char c), int32_t val, int8_t rad, int8_t len) {
   char c, sgn = 0, pad = ' ';
+  uint32_t uval;
   char s[20];
   uint8_t i = 0;
 
@@ -128,13 +198,21 @@ void _itoa(void (*putchar) (char c), int32_t val, int8_t rad, int8_t len) {
     pad = '0';
   }
   if(len > 20) return;
+  uval = val;
   do {
-    c = (char)((uint32_t)val % rad);
+    if(rad == 10) c = _divmod10(&uval);
+    else if(rad == 16) {
+      c = uval & 0x0f;
+      uval >>= 4;
+    }
+    else {
+      c = uval & 0x01;
+      uval >>= 1;
+    }
     if (c >= 10) c += ('A' - 10);
     else c += '0';
     s[i++] = c;
-    val = (uint32_t)val / rad;
-  } while(val);
+  } while(uval);
   if((sgn != 0) && (pad != '0')) s[i++] = sgn;
   while(i < len) s[i++] = pad;
   if((sgn != 0) && (pad == '0')) s[i++] = sgn;
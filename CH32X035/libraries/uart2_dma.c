@@ -1,5 +1,5 @@
 // ===================================================================================
-// USART2 with DMA RX Buffer for CH32X035/X034/X033                           * v1.0 *
+// USART2 with DMA RX Buffer for CH32X035/X034/X033                           * v1.1 *
 // ===================================================================================
 // 2023 by Stefan Wagner:   https://github.com/wagiminator
 
@@ -94,3 +94,18 @@ void UART2_write(const char c) {
   while(!UART2_ready());
   USART2->DATAR = c;
 }
+
+// Get pointer to longest contiguous readable span in RX buffer, return its length
+uint16_t UART2_peek(const char** ptr) {
+  uint16_t hptr = UART2_RX_hptr;
+  *ptr = UART2_RX_buffer + UART2_RX_tptr;
+  if(hptr >= UART2_RX_tptr) return(hptr - UART2_RX_tptr);
+  return(UART2_RX_BUF_SIZE - UART2_RX_tptr);
+}
+
+// Remove n bytes from RX buffer
+void UART2_consume(uint16_t n) {
+  n += UART2_RX_tptr;
+  if(n >= UART2_RX_BUF_SIZE) n -= UART2_RX_BUF_SIZE;
+  UART2_RX_tptr = n;
+}
@@ -1,5 +1,5 @@
 // ===================================================================================
-// USART2 with DMA RX Buffer for CH32X035/X034/X033                           * v1.0 *
+// USART2 with DMA RX Buffer for CH32X035/X034/X033                           * v1.1 *
 // ===================================================================================
 //
 // Functions available:
@@ -16,6 +16,8 @@
 // UART2_completed()        Check if transmission is completed
 //
 // UART2_read()             Read character via UART
+// UART2_peek(&p)           Get pointer (p) to contiguous received data, returns length
+// UART2_consume(n)         Remove n bytes from RX buffer (after UART2_peek)
 // UART2_write(c)           Send character via UART
 //
 // UART2_enable()           Enable UART
@@ -92,6 +94,8 @@ void UART2_init(void);                    // init UART with default BAUD rate
 char UART2_read(void);                    // read character via UART
 void UART2_write(const char c);           // send character via UART
 uint8_t UART2_available(void);            // check if there is something to read
+uint16_t UART2_peek(const char** ptr);    // get contiguous readable span
+void UART2_consume(uint16_t n);           // remove n bytes from RX buffer
 
 // ===================================================================================
 // Additional Print Functions (if activated, see above)
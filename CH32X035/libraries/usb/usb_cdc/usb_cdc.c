@@ -1,5 +1,5 @@
 // ===================================================================================
-// Basic USB CDC Functions for CH32X035/X034/X033                             * v1.0 *
+// Basic USB CDC Functions for CH32X035/X034/X033                             * v1.2 *
 // ===================================================================================
 
 #include "usb_cdc.h"
@@ -18,16 +18,97 @@ CDC_LINE_CODING_TYPE CDC_lineCoding = {
 
 // Variables
 volatile uint8_t CDC_controlLineState = 0;  // control line state
-volatile uint8_t CDC_readByteCount = 0;     // number of data bytes in IN buffer
-volatile uint8_t CDC_readPointer   = 0;     // data pointer for fetching
-volatile uint8_t CDC_writePointer  = 0;     // data pointer for writing
 volatile uint8_t CDC_writeBusyFlag = 0;     // flag of whether upload pointer is busy
+volatile uint8_t CDC_flushFlag     = 0;     // flag of whether a flush was requested
+volatile uint8_t CDC_ZLPflag       = 0;     // flag of whether last packet was full
+volatile uint8_t CDC_readStallFlag = 0;     // flag of whether host gets NAK (RX full)
+
+#if (CDC_RX_BUF_SIZE <= EP2_SIZE) || (CDC_TX_BUF_SIZE <= EP2_SIZE)
+  #error CDC ring buffers must be larger than the endpoint size!
+#endif
+
+// Ring buffers (head pointer written by producer, tail pointer by consumer)
+char CDC_RX_buffer[CDC_RX_BUF_SIZE];        // data received from host
+char CDC_TX_buffer[CDC_TX_BUF_SIZE];        // data to be sent to host
+volatile uint16_t CDC_RX_hptr = 0;          // RX head (written by USB ISR)
+volatile uint16_t CDC_RX_tptr = 0;          // RX tail (written by main code)
+volatile uint16_t CDC_TX_hptr = 0;          // TX head (written by main code)
+volatile uint16_t CDC_TX_tptr = 0;          // TX tail (written by USB ISR)
+
+// Number of bytes in ring buffers (each pointer is read only once, since the other
+// side may wrap it around at any time)
+static inline uint16_t CDC_RX_used(void) {
+  uint16_t hptr = CDC_RX_hptr;
+  uint16_t tptr = CDC_RX_tptr;
+  return(hptr >= tptr ? hptr - tptr : hptr - tptr + CDC_RX_BUF_SIZE);
+}
+
+static inline uint16_t CDC_TX_used(void) {
+  uint16_t hptr = CDC_TX_hptr;
+  uint16_t tptr = CDC_TX_tptr;
+  return(hptr >= tptr ? hptr - tptr : hptr - tptr + CDC_TX_BUF_SIZE);
+}
+
+#define CDC_RX_free() (CDC_RX_BUF_SIZE - 1 - CDC_RX_used())
+#define CDC_TX_free() (CDC_TX_BUF_SIZE - 1 - CDC_TX_used())
+
+// Keep USB ISR from changing endpoint state while main code arms endpoint
+#define CDC_lock()    NVIC_DisableIRQ(USBFS_IRQn)
+#define CDC_unlock()  NVIC_EnableIRQ(USBFS_IRQn)
 
 // CDC class requests
 #define SET_LINE_CODING           0x20      // host configures line coding
 #define GET_LINE_CODING           0x21      // host reads configured line coding
 #define SET_CONTROL_LINE_STATE    0x22      // generates RS-232/V.24 style control signals
 
+// ===================================================================================
+// Endpoint Buffer Handling
+// ===================================================================================
+
+// Load next packet from TX ring buffer into EP2 and arm it (EP2 must be idle).
+// Full packets are sent as soon as available, the remainder only after a flush.
+// A transfer ending with a full packet is terminated by a zero-length packet.
+static void CDC_TX_load(void) {
+  uint8_t  len, i;
+  uint16_t tptr  = CDC_TX_tptr;
+  uint16_t used  = CDC_TX_used();
+  if(used >= EP2_SIZE) len = EP2_SIZE;                  // full packet
+  else if(CDC_flushFlag && (used || CDC_ZLPflag)) {     // short packet or ZLP
+    len = used;
+    CDC_flushFlag = 0;
+  }
+  else {                                                // nothing to send
+    CDC_flushFlag = 0;
+    return;
+  }
+  for(i=0; i<len; i++) {                                // copy packet
+    EP2_buffer[64 + i] = CDC_TX_buffer[tptr++];
+    if(tptr >= CDC_TX_BUF_SIZE) tptr = 0;
+  }
+  CDC_TX_tptr = tptr;
+  CDC_ZLPflag = (len == EP2_SIZE);
+  CDC_writeBusyFlag   = 1;                              // busy for now
+  USBFSD->UEP2_TX_LEN = len;                            // number of bytes in packet
+  USBFSD->UEP2_CTRL_H = (USBFSD->UEP2_CTRL_H & ~USBFS_UEP_T_RES_MASK) | USBFS_UEP_T_RES_ACK;
+}
+
+// Start sending from main code if EP2 is idle
+static void CDC_TX_kick(void) {
+  CDC_lock();
+  if(!CDC_writeBusyFlag) CDC_TX_load();
+  CDC_unlock();
+}
+
+// Let host send next packet if there is enough space in RX ring buffer
+static void CDC_RX_release(void) {
+  if(CDC_readStallFlag && (CDC_RX_free() >= EP2_SIZE)) {
+    CDC_lock();
+    CDC_readStallFlag = 0;
+    USBFSD->UEP2_CTRL_H = (USBFSD->UEP2_CTRL_H & ~USBFS_UEP_R_RES_MASK) | USBFS_UEP_R_RES_ACK;
+    CDC_unlock();
+  }
+}
+
 // ===================================================================================
 // Front End Functions
 // ===================================================================================
@@ -38,42 +119,75 @@ void CDC_init(void) {
 }
 
 // Check number of bytes in the IN buffer
-uint8_t CDC_available(void) {
-  return CDC_readByteCount;
+uint16_t CDC_available(void) {
+  return CDC_RX_used();
 }
 
 // Check if OUT buffer is ready to be written
 uint8_t CDC_ready(void) {
-  return(!CDC_writeBusyFlag);
+  return(CDC_TX_free() > 0);
 }
 
 // Flush the OUT buffer
 void CDC_flush(void) {
-  if(!CDC_writeBusyFlag && CDC_writePointer > 0) {      // not busy and buffer not empty?
-    USBFSD->UEP2_TX_LEN = CDC_writePointer;             // number of bytes in OUT buffer
-    USBFSD->UEP2_CTRL_H = (USBFSD->UEP2_CTRL_H & ~USBFS_UEP_T_RES_MASK) | USBFS_UEP_T_RES_ACK;
-    CDC_writeBusyFlag = 1;                              // busy for now
-    CDC_writePointer  = 0;                              // reset write pointer
-  }
+  CDC_flushFlag = 1;                                    // send remainder
+  CDC_TX_kick();                                        // start if EP2 is idle
 }
 
 // Write single character to OUT buffer
 void CDC_write(char c) {
-  while(CDC_writeBusyFlag);                             // wait for ready to write
-  EP2_buffer[64 + CDC_writePointer++] = c;              // write character
-  if(CDC_writePointer == EP2_SIZE) CDC_flush();         // flush if buffer full
+  uint16_t hptr = CDC_TX_hptr;
+  while(!CDC_TX_free());                                // wait for space in buffer
+  CDC_TX_buffer[hptr++] = c;                            // write character
+  if(hptr >= CDC_TX_BUF_SIZE) hptr = 0;
+  CDC_TX_hptr = hptr;
+  if(CDC_TX_used() >= EP2_SIZE) CDC_TX_kick();          // send if packet is full
+}
+
+// Write buffer to OUT buffer (copied block-wise)
+void CDC_writeBuffer(const char* buf, uint16_t len) {
+  uint16_t cnt, hptr;
+  while(len) {
+    while(!(cnt = CDC_TX_free()));                      // wait for space in buffer
+    if(cnt > len) cnt = len;
+    len -= cnt;
+    hptr = CDC_TX_hptr;
+    while(cnt--) {                                      // copy data
+      CDC_TX_buffer[hptr++] = *buf++;
+      if(hptr >= CDC_TX_BUF_SIZE) hptr = 0;
+    }
+    CDC_TX_hptr = hptr;
+    if(CDC_TX_used() >= EP2_SIZE) CDC_TX_kick();        // send full packets
+  }
 }
 
 // Read single character from IN buffer
 char CDC_read(void) {
   char data;
-  while(!CDC_readByteCount);                            // wait for data
-  data = EP2_buffer[CDC_readPointer++];                 // get character
-  if(--CDC_readByteCount == 0)                          // dec number of bytes in buffer
-    USBFSD->UEP2_CTRL_H = (USBFSD->UEP2_CTRL_H & ~USBFS_UEP_R_RES_MASK) | USBFS_UEP_R_RES_ACK;
+  uint16_t tptr = CDC_RX_tptr;
+  while(tptr == CDC_RX_hptr);                           // wait for data
+  data = CDC_RX_buffer[tptr++];                         // get character
+  if(tptr >= CDC_RX_BUF_SIZE) tptr = 0;
+  CDC_RX_tptr = tptr;
+  CDC_RX_release();                                     // re-arm EP2 if necessary
   return data;
 }
 
+// Read up to (len) bytes from IN buffer into buffer (buf), returns number of bytes
+uint16_t CDC_readBuffer(char* buf, uint16_t len) {
+  uint16_t cnt = CDC_RX_used();
+  uint16_t tptr = CDC_RX_tptr;
+  if(cnt > len) cnt = len;
+  len = cnt;
+  while(cnt--) {                                        // copy data
+    *buf++ = CDC_RX_buffer[tptr++];
+    if(tptr >= CDC_RX_BUF_SIZE) tptr = 0;
+  }
+  CDC_RX_tptr = tptr;
+  CDC_RX_release();                                     // re-arm EP2 if necessary
+  return len;
+}
+
 // ===================================================================================
 // CDC-Specific USB Handler Functions
 // ===================================================================================
@@ -93,8 +207,12 @@ void CDC_EP_init(void) {
   USBFSD->UEP1_TX_LEN = 0;                      // Nothing to send
   USBFSD->UEP2_TX_LEN = 0;                      // Nothing to send
 
-  CDC_readByteCount   = 0;                      // reset received bytes counter
-  CDC_writeBusyFlag   = 0;                      // reset write busy flag
+  CDC_RX_hptr = 0; CDC_RX_tptr = 0;             // reset RX ring buffer
+  CDC_TX_hptr = 0; CDC_TX_tptr = 0;             // reset TX ring buffer
+  CDC_writeBusyFlag   = 0;                      // reset flags
+  CDC_flushFlag       = 0;
+  CDC_ZLPflag         = 0;
+  CDC_readStallFlag   = 0;
 }
 
 // Handle class setup requests
@@ -134,14 +252,25 @@ void CDC_EP0_OUT(void) {
 void CDC_EP2_IN(void) {
   CDC_writeBusyFlag = 0;                                // clear busy flag
   USBFSD->UEP2_CTRL_H = (USBFSD->UEP2_CTRL_H & ~USBFS_UEP_T_RES_MASK) | USBFS_UEP_T_RES_NAK;
+  CDC_TX_load();                                        // re-arm with next packet
 }
 
 // Endpoint 2 OUT handler (bulk data transfer from host)
 void CDC_EP2_OUT(void) {
+  uint8_t  len, i;
+  uint16_t hptr;
   if((USBFSD->INT_FG & USBFS_U_TOG_OK) && USBFSD->RX_LEN) {
-    // respond NAK after a packet. Let main code change response after handling.
-    USBFSD->UEP2_CTRL_H = (USBFSD->UEP2_CTRL_H & ~USBFS_UEP_R_RES_MASK) | USBFS_UEP_R_RES_NAK;
-    CDC_readByteCount   = USBFSD->RX_LEN;             // set number of received data bytes
-    CDC_readPointer     = 0;                          // reset read pointer for fetching
+    len  = USBFSD->RX_LEN;                              // number of received bytes
+    hptr = CDC_RX_hptr;
+    for(i=0; i<len; i++) {                              // copy packet to ring buffer
+      CDC_RX_buffer[hptr++] = EP2_buffer[i];
+      if(hptr >= CDC_RX_BUF_SIZE) hptr = 0;
+    }
+    CDC_RX_hptr = hptr;
+    if(CDC_RX_free() < EP2_SIZE) {                      // no space for next packet?
+      // respond NAK, main code re-arms endpoint after reading
+      CDC_readStallFlag = 1;
+      USBFSD->UEP2_CTRL_H = (USBFSD->UEP2_CTRL_H & ~USBFS_UEP_R_RES_MASK) | USBFS_UEP_R_RES_NAK;
+    }
   }
 }
@@ -1,13 +1,16 @@
 // ===================================================================================
-// Basic USB CDC Functions for CH32X035/X034/X033                             * v1.0 *
+// Basic USB CDC Functions for CH32X035/X034/X033                             * v1.2 *
 // ===================================================================================
 //
 // Functions available:
 // --------------------
 // CDC_init()               setup USB CDC
 // CDC_read()               read single character from receive buffer
+// CDC_readBuffer(b,n)      read up to (n) bytes from receive buffer into buffer (b),
+//                          returns number of bytes read (does not wait for data)
 // CDC_write(c)             write single character to transmit buffer
-// CDC_flush()              flush transmit buffer
+// CDC_writeBuffer(b,n)     write buffer (b) with length (n) to transmit buffer
+// CDC_flush()              flush transmit buffer (send remaining bytes)
 // CDC_writeflush(c)        write & flush character
 // CDC_newline()            newline and flush
 //
@@ -21,6 +24,17 @@
 // CDC_getStopBits()        get number of stop bits (0:1bit, 1:1.5bits, 2:2bits)
 // CDC_getDataBits()        get number of data bits (5, 6, 7, 8, or 16)
 //
+// Notes:
+// ------
+// - Received and transmitted data is held in ring buffers, decoupled from the
+//   endpoint buffer. The USB interrupt copies each received packet into the RX ring
+//   buffer and immediately accepts the next one as long as there is space for it.
+//   Full packets are sent from the TX ring buffer as soon as they are available and
+//   the endpoint is re-armed from the interrupt, the remaining bytes are sent after
+//   CDC_flush(). A transfer ending with a full packet is terminated by a zero-length
+//   packet.
+// - For continuous streaming the buffer sizes should be at least 2 * 64 bytes.
+//
 // If print functions are activated (see below, print.h must be included):
 // -----------------------------------------------------------------------
 // CDC_printf(f, ...)       printf (supports %s, %c, %d, %u, %x, %b, %02d, %%)
@@ -48,6 +62,8 @@ extern "C" {
 // CDC Parameters
 // ===================================================================================
 #define CDC_PRINT       0         // 1: include print functions (needs print.h)
+#define CDC_RX_BUF_SIZE 256       // RX ring buffer size (min 65)
+#define CDC_TX_BUF_SIZE 256       // TX ring buffer size (min 65)
 
 // ===================================================================================
 // CDC Functions
@@ -55,8 +71,10 @@ extern "C" {
 void CDC_init(void);              // setup USB-CDC
 void CDC_flush(void);             // flush OUT buffer
 char CDC_read(void);              // read single character from IN buffer
+uint16_t CDC_readBuffer(char* buf, uint16_t len);     // read IN buffer into buffer
 void CDC_write(char c);           // write single character to OUT buffer
-uint8_t CDC_available(void);      // check number of bytes in the IN buffer
+void CDC_writeBuffer(const char* buf, uint16_t len);  // write buffer to OUT buffer
+uint16_t CDC_available(void);     // check number of bytes in the IN buffer
 uint8_t CDC_ready(void);          // check if OUT buffer is ready to be written
 
 #define CDC_writeflush(c)         {CDC_write(c);CDC_flush();}     // write & flush char
@@ -99,7 +117,7 @@ extern CDC_LINE_CODING_TYPE CDC_lineCoding;
 #define CDC_printS(s)         printS(CDC_write, s)    // print string
 #define CDC_println(s)        {println(CDC_write, s); CDC_flush();}
 #define CDC_print             CDC_printS              // alias
-#define CDC_printf(f, ...)    {printF(CDC_write, f, ##__VA_ARGS__); CDC_flush();}
+#define CDC_printf(f, ...)    {printFB(CDC_writeBuffer, f, ##__VA_ARGS__); CDC_flush();}
 #endif
 
 #ifdef __cplusplus
@@ -1,5 +1,5 @@
 // ===================================================================================
-// NeoPixel (Addressable LED) Functions for CH551, CH552 and CH554            * v1.2 *
+// NeoPixel (Addressable LED) Functions for CH551, CH552 and CH554            * v1.3 *
 // ===================================================================================
 //
 // Basic control functions for 800kHz addressable LEDs (NeoPixel). A simplified 
@@ -26,6 +26,6 @@
 void NEO_sendByte(uint8_t data);                                      // send a single byte to the pixels
 void NEO_clearAll(void);                                              // clear all pixels
 void NEO_update(void);                                                // write buffer to pixels
-void NEO_writeColor(uint8_t pixel, uint8_t r, uint8_t g, uint8_t b);  // write color to pixel in buffer
-void NEO_writeHue(uint8_t pixel, uint8_t hue, uint8_t bright);        // hue (0..191), brightness (0..2)
-void NEO_clearPixel(uint8_t pixel);                                   // clear one pixel in buffer
+void NEO_writeColor(uint16_t pixel, uint8_t r, uint8_t g, uint8_t b); // write color to pixel in buffer
+void NEO_writeHue(uint16_t pixel, uint8_t hue, uint8_t bright);       // hue (0..191), brightness (0..2)
+void NEO_clearPixel(uint16_t pixel);                                  // clear one pixel in buffer
@@ -0,0 +1,120 @@
+// ===================================================================================
+// COBS Packet Framing with CRC-16 over UART                                  * v1.0 *
+// ===================================================================================
+// 2023 by Stefan Wagner:   https://github.com/wagiminator
+
+#include "cobs.h"
+
+// ===================================================================================
+// CRC-16 (CCITT, nibble-wise table lookup, no multiplication needed)
+// ===================================================================================
+const uint16_t COBS_CRC_TABLE[] = {
+  0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+  0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+};
+
+// Update CRC-16 with one byte
+static inline uint16_t COBS_crcByte(uint16_t crc, uint8_t data) {
+  crc = (crc << 4) ^ COBS_CRC_TABLE[(crc >> 12) ^ (data >> 4)];
+  crc = (crc << 4) ^ COBS_CRC_TABLE[(crc >> 12) ^ (data & 0x0f)];
+  return crc;
+}
+
+// Update CRC-16 with buffer
+uint16_t COBS_crc16(uint16_t crc, const uint8_t* buf, uint16_t len) {
+  while(len--) crc = COBS_crcByte(crc, *buf++);
+  return crc;
+}
+
+// ===================================================================================
+// Encoder
+// ===================================================================================
+
+// Frame buffer (payload, CRC, code bytes and delimiter)
+uint8_t COBS_TX_buffer[COBS_MAX_LEN + 2 + (COBS_MAX_LEN + 2) / 254 + 3];
+static uint8_t* COBS_TX_codeptr;              // position of current code byte
+static uint8_t* COBS_TX_ptr;                  // current write position
+static uint8_t  COBS_TX_code;                 // current code value
+
+// Encode one byte into frame buffer
+static inline void COBS_encodeByte(uint8_t data) {
+  if(data) {                                  // data byte?
+    *COBS_TX_ptr++ = data;                    // -> copy it
+    COBS_TX_code++;                           // -> increase code value
+  }
+  if(!data || COBS_TX_code == 0xFF) {         // zero byte or block full?
+    *COBS_TX_codeptr = COBS_TX_code;          // -> finish current block
+    COBS_TX_codeptr  = COBS_TX_ptr++;         // -> start next block
+    COBS_TX_code     = 1;
+  }
+}
+
+// Encode packet and send frame as one block, returns 0 if packet is too long
+uint8_t COBS_send(const uint8_t* buf, uint16_t len) {
+  uint16_t crc;
+  if(len > COBS_MAX_LEN) return 0;            // packet too long
+  crc = COBS_crc16(0xFFFF, buf, len);         // calculate CRC-16
+  COBS_TX_codeptr = COBS_TX_buffer;           // first code byte
+  COBS_TX_ptr     = COBS_TX_buffer + 1;       // first data byte
+  COBS_TX_code    = 1;
+  while(len--) COBS_encodeByte(*buf++);       // encode payload
+  COBS_encodeByte(crc >> 8);                  // encode CRC-16 (MSB first)
+  COBS_encodeByte(crc);
+  *COBS_TX_codeptr = COBS_TX_code;            // finish last block
+  *COBS_TX_ptr++   = 0x00;                    // frame delimiter
+  COBS_write(COBS_TX_buffer, COBS_TX_ptr - COBS_TX_buffer);
+  return 1;
+}
+
+// ===================================================================================
+// Decoder (incremental, byte by byte across any number of calls)
+// ===================================================================================
+
+// Packet buffer (payload and CRC)
+uint8_t COBS_RX_buffer[COBS_MAX_LEN + 2];
+static uint16_t COBS_RX_len   = 0;            // number of decoded bytes
+static uint16_t COBS_RX_crc   = 0xFFFF;       // running CRC of decoded bytes
+static uint8_t  COBS_RX_code  = 0;            // code of current block (0: frame start)
+static uint8_t  COBS_RX_cnt   = 0;            // remaining data bytes in current block
+static uint8_t  COBS_RX_error = 0;            // frame too long
+
+void (*COBS_callback)(const uint8_t* buf, uint16_t len) = 0;
+uint16_t COBS_dropCount = 0;
+
+// Append decoded byte to packet buffer
+static inline void COBS_decodeByte(uint8_t data) {
+  if(COBS_RX_len >= sizeof(COBS_RX_buffer)) COBS_RX_error = 1;
+  else {
+    COBS_RX_buffer[COBS_RX_len++] = data;
+    COBS_RX_crc = COBS_crcByte(COBS_RX_crc, data);
+  }
+}
+
+// Feed received bytes into the decoder
+void COBS_receive(const uint8_t* buf, uint16_t len) {
+  uint8_t data;
+  while(len--) {
+    data = *buf++;
+    if(!data) {                                 // frame delimiter?
+      if(!COBS_RX_error && !COBS_RX_cnt && (COBS_RX_len >= 2) && !COBS_RX_crc) {
+        if(COBS_callback) COBS_callback(COBS_RX_buffer, COBS_RX_len - 2);
+      }
+      else if(COBS_RX_len || COBS_RX_error) COBS_dropCount++;
+      COBS_RX_len   = 0;                        // reset decoder for next frame
+      COBS_RX_crc   = 0xFFFF;
+      COBS_RX_code  = 0;
+      COBS_RX_cnt   = 0;
+      COBS_RX_error = 0;
+    }
+    else if(!COBS_RX_cnt) {                     // code byte?
+      if(COBS_RX_code && (COBS_RX_code != 0xFF))
+        COBS_decodeByte(0x00);                  // -> insert implicit zero
+      COBS_RX_code = data;
+      COBS_RX_cnt  = data - 1;
+    }
+    else {                                      // data byte?
+      COBS_decodeByte(data);
+      COBS_RX_cnt--;
+    }
+  }
+}
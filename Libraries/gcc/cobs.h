@@ -0,0 +1,61 @@
+// ===================================================================================
+// COBS Packet Framing with CRC-16 over UART                                  * v1.0 *
+// ===================================================================================
+//
+// Binary packets are protected by a CRC-16 (CCITT, poly 0x1021, init 0xFFFF, appended
+// MSB first), encoded with Consistent Overhead Byte Stuffing (COBS) and terminated by
+// a zero byte. Thus a zero byte always marks the end of a frame, the receiver can
+// resynchronize at any time and the overhead is only 1 byte per 254 bytes.
+//
+// Frame: COBS(payload + CRC-16) + 0x00
+//
+// Functions available:
+// --------------------
+// COBS_send(buf, len)      Encode packet (buf) with length (len), send it as one block
+//                          via COBS_write (e.g. UART DMA TX), returns 0 if too long
+// COBS_receive(buf, len)   Feed received bytes (e.g. a DMA RX span) into the decoder,
+//                          complete packets with valid CRC are handed to the callback
+// COBS_poll()              Feed all received bytes of the UART DMA RX ring buffer into
+//                          the decoder (uses UART_peek/UART_consume, no copying)
+// COBS_setCallback(f)      Set function f(buf, len) called with each valid packet
+// COBS_dropped()           Get number of dropped frames (CRC error or too long)
+// COBS_crc16(crc, buf, len) Update CRC-16 (start with 0xFFFF) with buffer
+//
+// 2023 by Stefan Wagner:   https://github.com/wagiminator
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "uart_dma.h"                 // choose your UART library
+
+// COBS parameters
+#define COBS_MAX_LEN      64          // maximum payload length in bytes
+#define COBS_write(b,n)   UART_writeBuffer((const char*)(b), n) // block write function
+
+// COBS functions
+uint8_t COBS_send(const uint8_t* buf, uint16_t len);      // encode and send packet
+void COBS_receive(const uint8_t* buf, uint16_t len);      // feed received bytes
+uint16_t COBS_crc16(uint16_t crc, const uint8_t* buf, uint16_t len); // update CRC-16
+
+// COBS variables
+extern void (*COBS_callback)(const uint8_t* buf, uint16_t len);
+extern uint16_t COBS_dropCount;
+
+// COBS macros
+#define COBS_setCallback(f)   COBS_callback = (f)         // set packet callback
+#define COBS_dropped()        (COBS_dropCount)            // number of dropped frames
+#define COBS_poll() do {                                  \
+  const char* COBS_ptr;                                   \
+  uint16_t COBS_cnt = UART_peek(&COBS_ptr);               \
+  if(COBS_cnt) {                                          \
+    COBS_receive((const uint8_t*)COBS_ptr, COBS_cnt);     \
+    UART_consume(COBS_cnt);                               \
+  }                                                       \
+} while(0)
+
+#ifdef __cplusplus
+};
+#endif
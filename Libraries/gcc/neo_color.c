@@ -0,0 +1,113 @@
+// ===================================================================================
+// NeoPixel Color Functions with Gamma/Brightness Correction and HSV          * v1.0 *
+// ===================================================================================
+// 2023 by Stefan Wagner:   https://github.com/wagiminator
+
+#include "neo_color.h"
+
+// ===================================================================================
+// Lookup Tables
+// ===================================================================================
+#if NEO_GAMMA > 0
+// Gamma correction table (gamma 2.8)
+const uint8_t NEO_GAMMA_TABLE[256] = {
+    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   1,   1,   1,   1,
+    1,   1,   1,   1,   1,   1,   1,   1,   1,   2,   2,   2,   2,   2,   2,   2,
+    2,   3,   3,   3,   3,   3,   3,   3,   4,   4,   4,   4,   4,   5,   5,   5,
+    5,   6,   6,   6,   6,   7,   7,   7,   7,   8,   8,   8,   9,   9,   9,  10,
+   10,  10,  11,  11,  11,  12,  12,  13,  13,  13,  14,  14,  15,  15,  16,  16,
+   17,  17,  18,  18,  19,  19,  20,  20,  21,  21,  22,  22,  23,  24,  24,  25,
+   25,  26,  27,  27,  28,  29,  29,  30,  31,  32,  32,  33,  34,  35,  35,  36,
+   37,  38,  39,  39,  40,  41,  42,  43,  44,  45,  46,  47,  48,  49,  50,  50,
+   51,  52,  54,  55,  56,  57,  58,  59,  60,  61,  62,  63,  64,  66,  67,  68,
+   69,  70,  72,  73,  74,  75,  77,  78,  79,  81,  82,  83,  85,  86,  87,  89,
+   90,  92,  93,  95,  96,  98,  99, 101, 102, 104, 105, 107, 109, 110, 112, 114,
+  115, 117, 119, 120, 122, 124, 126, 127, 129, 131, 133, 135, 137, 138, 140, 142,
+  144, 146, 148, 150, 152, 154, 156, 158, 160, 162, 164, 167, 169, 171, 173, 175,
+  177, 180, 182, 184, 186, 189, 191, 193, 196, 198, 200, 203, 205, 208, 210, 213,
+  215, 218, 220, 223, 225, 228, 231, 233, 236, 239, 241, 244, 247, 249, 252, 255
+};
+#endif
+
+uint8_t NEO_lut[256];                         // gamma/brightness lookup table
+
+// Scale value (0..255) by factor (0..255), 255 leaves value unchanged. Cores without
+// a hardware multiplier (RV32EC) use shift-and-add instead of the slow multiplication
+// routine of libgcc; full scale operands (common with HSV) need no loop at all.
+#if defined(__riscv_mul) || defined(__arm__) || defined(__AVR_HAVE_MUL__)
+static inline uint8_t NEO_scale(uint8_t value, uint8_t factor) {
+  return ((uint16_t)value * (factor + 1)) >> 8;
+}
+#else
+static inline uint8_t NEO_scale(uint8_t value, uint8_t factor) {
+  uint16_t sum, add;
+  if(factor == 255) return value;             // value * 256 >> 8
+  if(value  == 255) return factor;            // 255 * (factor + 1) >> 8
+  sum = add = value;                          // value * (factor + 1) = value + ...
+  while(factor) {                             // ... value * factor, bit by bit
+    if(factor & 1) sum += add;
+    add <<= 1;
+    factor >>= 1;
+  }
+  return sum >> 8;
+}
+#endif
+
+// ===================================================================================
+// Set Global Brightness and rebuild Lookup Table
+// ===================================================================================
+void NEO_setBrightness(uint8_t bright) {
+  uint8_t i = 0;
+  do {
+    #if NEO_GAMMA > 0
+    NEO_lut[i] = NEO_scale(NEO_GAMMA_TABLE[i], bright);
+    #else
+    NEO_lut[i] = NEO_scale(i, bright);
+    #endif
+  } while(++i);
+}
+
+// ===================================================================================
+// Convert HSV (hue 0..255, saturation 0..255, value 0..255) to RGB
+// ===================================================================================
+void NEO_hsv2rgb(uint8_t h, uint8_t s, uint8_t v, uint8_t* rgb) {
+  uint16_t h6 = ((uint16_t)h << 2) + ((uint16_t)h << 1);  // h * 6 without MUL
+  uint8_t  f  = h6;                           // position within sector
+  uint8_t  p  = NEO_scale(v, 255 - s);        // lowest channel
+  uint8_t  q  = NEO_scale(v, 255 - NEO_scale(s, f));        // falling channel
+  uint8_t  t  = NEO_scale(v, 255 - NEO_scale(s, 255 - f));  // rising channel
+  switch(h6 >> 8) {                           // sector (0..5)
+    case 0:   rgb[0] = v; rgb[1] = t; rgb[2] = p; break;
+    case 1:   rgb[0] = q; rgb[1] = v; rgb[2] = p; break;
+    case 2:   rgb[0] = p; rgb[1] = v; rgb[2] = t; break;
+    case 3:   rgb[0] = p; rgb[1] = q; rgb[2] = v; break;
+    case 4:   rgb[0] = t; rgb[1] = p; rgb[2] = v; break;
+    default:  rgb[0] = v; rgb[1] = p; rgb[2] = q; break;
+  }
+}
+
+// ===================================================================================
+// Write corrected Colors to Pixels
+// ===================================================================================
+
+// Write corrected RGB color to a single pixel
+void NEO_writeRGB(uint16_t pixel, uint8_t r, uint8_t g, uint8_t b) {
+  NEO_writeColor(pixel, NEO_lut[r], NEO_lut[g], NEO_lut[b]);
+}
+
+// Write corrected HSV color to a single pixel
+void NEO_writeHSV(uint16_t pixel, uint8_t h, uint8_t s, uint8_t v) {
+  uint8_t rgb[3];
+  NEO_hsv2rgb(h, s, v, rgb);
+  NEO_writeColor(pixel, NEO_lut[rgb[0]], NEO_lut[rgb[1]], NEO_lut[rgb[2]]);
+}
+
+// Write array of RGB colors to pixels 0..n-1, correction is applied while encoding
+void NEO_writeBuffer(const uint8_t* rgb, uint16_t n) {
+  uint16_t pixel;
+  if(n > NEO_COUNT) n = NEO_COUNT;
+  for(pixel=0; pixel<n; pixel++, rgb+=3) {
+    NEO_writeColor(pixel, NEO_lut[rgb[0]], NEO_lut[rgb[1]], NEO_lut[rgb[2]]);
+  }
+}
@@ -0,0 +1,65 @@
+// ===================================================================================
+// NeoPixel Color Functions with Gamma/Brightness Correction and HSV          * v1.0 *
+// ===================================================================================
+//
+// Color pipeline on top of a basic NeoPixel library. All colors written via these
+// functions pass through one 256-byte lookup table, which combines gamma correction
+// (constant table in flash, generated for gamma 2.8) and global brightness. Thus
+// correcting a color byte costs a single load instead of multiplications, which
+// are slow on cores without hardware multiplier (e.g. rv32ec).
+//
+// Cost per pixel on cores without hardware multiplier:
+// - NEO_writeRGB(), NEO_writeBuffer(): 3 table loads.
+// - NEO_writeHSV(): 3 table loads plus up to 5 shift-and-add 8x8 scalings of at
+//   most 8 loop iterations each (no libgcc calls). Scalings with saturation or
+//   value 255 are skipped, a fully saturated rainbow at full value needs none.
+//   The hue wheel of the NeoPixel libraries (NEO_writeHue) is still cheaper.
+//
+// Functions available:
+// --------------------
+// NEO_setBrightness(b)     set global brightness (0..255) and rebuild lookup table,
+//                          must be called once before the functions below are used
+// NEO_writeRGB(p,r,g,b)    write corrected RGB color to pixel p
+// NEO_writeHSV(p,h,s,v)    write corrected color from hue (0..255), saturation (0..255)
+//                          and value (0..255) to pixel p
+// NEO_writeBuffer(rgb,n)   write n corrected RGB colors (3 bytes each, R-G-B) from
+//                          array rgb to pixels 0..n-1
+// NEO_hsv2rgb(h,s,v,rgb)   convert HSV to RGB (3 bytes, not corrected) into array rgb
+// NEO_correct(c)           get corrected value of color byte c
+//
+// Notes:
+// ------
+// - Works with every NeoPixel library providing NEO_writeColor(p,r,g,b), choose it
+//   below (neo_sw.h, neo_spi.h or neo_dma.h). NEO_update() etc. are used as usual.
+// - The lookup table takes 256 bytes of RAM.
+// - Set NEO_GAMMA to 0 for linear brightness scaling without gamma correction.
+//
+// 2023 by Stefan Wagner:   https://github.com/wagiminator
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "neo_spi.h"                  // choose your NeoPixel library
+
+// Color parameters
+#define NEO_GAMMA         1           // 1: gamma correction, 0: linear
+
+// Color variables
+extern uint8_t NEO_lut[256];          // gamma/brightness lookup table
+
+// Color functions
+void NEO_setBrightness(uint8_t bright);                             // set brightness
+void NEO_hsv2rgb(uint8_t h, uint8_t s, uint8_t v, uint8_t* rgb);    // HSV to RGB
+void NEO_writeRGB(uint16_t pixel, uint8_t r, uint8_t g, uint8_t b); // write RGB color
+void NEO_writeHSV(uint16_t pixel, uint8_t h, uint8_t s, uint8_t v); // write HSV color
+void NEO_writeBuffer(const uint8_t* rgb, uint16_t n);               // write RGB array
+
+// Color macros
+#define NEO_correct(c)    (NEO_lut[(uint8_t)(c)])                   // corrected byte
+
+#ifdef __cplusplus
+};
+#endif
@@ -0,0 +1,280 @@
+// ===================================================================================
+// NeoPixel Effects Engine with fixed Frame Rate                              * v1.0 *
+// ===================================================================================
+// 2023 by Stefan Wagner:   https://github.com/wagiminator
+
+#include "neo_fx.h"
+
+// ===================================================================================
+// Effects Engine Variables
+// ===================================================================================
+enum {NEO_FX_NONE, NEO_FX_FADE, NEO_FX_CHASE, NEO_FX_FIRE_ON, NEO_FX_RAINBOW};
+
+uint32_t NEO_FX_time;                         // ticks used by last frame
+uint32_t NEO_FX_count;                        // number of frames rendered
+uint16_t NEO_FX_missed;                       // number of frames missed their deadline
+uint8_t  NEO_FX_ok;                           // last frame met its deadline
+
+static uint32_t NEO_FX_next;                  // start of next frame (ticks)
+static uint8_t  NEO_FX_effect = NEO_FX_NONE;  // current effect
+static uint8_t  NEO_FX_color[3];              // solid color shown (R-G-B)
+static uint8_t  NEO_FX_dirty;                 // pixels changed outside of frame
+static uint16_t NEO_FX_seed = 0xACE1;         // random number generator seed
+
+// Effect states
+static union {
+  struct {
+    int32_t  value[3];                        // current color (8.8 fixed point)
+    int32_t  step[3];                         // change per frame (8.8 fixed point)
+    uint16_t frames;                          // frames left
+    uint8_t  out[3];                          // corrected color written last
+    uint8_t  target[3];                       // color at the end of the fade
+  } fade;
+  struct {
+    uint8_t  spacing;                         // every n-th pixel is lit
+    uint8_t  pos;                             // position of first lit pixel
+    uint8_t  frames;                          // frames per step
+    uint8_t  count;                           // frames left until next step
+  } chase;
+  struct {
+    uint8_t  sparking;                        // chance of new sparks
+    uint8_t  cooling;                         // maximum cooling per frame
+  } fire;
+  struct {
+    uint8_t  hue;                             // hue of first pixel
+    uint8_t  speed;                           // hue change per frame
+    uint8_t  spread;                          // hue distance between pixels
+  } rainbow;
+} NEO_FX_state;
+
+#if NEO_FX_FIRE > 0
+#if NEO_COUNT < 3
+  #error Fire effect needs at least 3 pixels!
+#endif
+static uint8_t NEO_FX_heat[NEO_COUNT];        // heat of each pixel (fire effect)
+#endif
+
+// ===================================================================================
+// Helper Functions
+// ===================================================================================
+
+// Get 8-bit pseudo random number (xorshift)
+static uint8_t NEO_FX_random(void) {
+  NEO_FX_seed ^= NEO_FX_seed << 7;
+  NEO_FX_seed ^= NEO_FX_seed >> 9;
+  NEO_FX_seed ^= NEO_FX_seed << 8;
+  return NEO_FX_seed;
+}
+
+// Get random number 0..(max-1)
+static inline uint8_t NEO_FX_randomMax(uint8_t max) {
+  return ((uint16_t)NEO_FX_random() * max) >> 8;
+}
+
+// Write color (already corrected) to all pixels
+static void NEO_FX_fill(uint8_t r, uint8_t g, uint8_t b) {
+  uint16_t i;
+  for(i=0; i<NEO_COUNT; i++) NEO_writeColor(i, r, g, b);
+}
+
+// ===================================================================================
+// Effect Steps (return 1 if any pixel was changed)
+// ===================================================================================
+
+// Fade: write all pixels only if the corrected color has changed
+static uint8_t NEO_FX_fadeStep(void) {
+  uint8_t i, out[3], changed = 0;
+  for(i=0; i<3; i++) {
+    if(NEO_FX_state.fade.frames > 1) NEO_FX_state.fade.value[i] += NEO_FX_state.fade.step[i];
+    else NEO_FX_state.fade.value[i] = (int32_t)NEO_FX_state.fade.target[i] << 8; // exact
+    NEO_FX_color[i] = NEO_FX_state.fade.value[i] >> 8;
+    out[i] = NEO_lut[NEO_FX_color[i]];
+    if(out[i] != NEO_FX_state.fade.out[i]) changed = 1;
+    NEO_FX_state.fade.out[i] = out[i];
+  }
+  if(!--NEO_FX_state.fade.frames) NEO_FX_effect = NEO_FX_NONE;          // fade done
+  if(changed) NEO_FX_fill(out[0], out[1], out[2]);
+  return changed;
+}
+
+// Chase: only the pixels moving are written
+static uint8_t NEO_FX_chaseStep(void) {
+  uint16_t i;
+  if(--NEO_FX_state.chase.count) return 0;
+  NEO_FX_state.chase.count = NEO_FX_state.chase.frames;
+  for(i=NEO_FX_state.chase.pos; i<NEO_COUNT; i+=NEO_FX_state.chase.spacing)
+    NEO_writeColor(i, 0, 0, 0);
+  if(++NEO_FX_state.chase.pos >= NEO_FX_state.chase.spacing) NEO_FX_state.chase.pos = 0;
+  for(i=NEO_FX_state.chase.pos; i<NEO_COUNT; i+=NEO_FX_state.chase.spacing)
+    NEO_writeRGB(i, NEO_FX_color[0], NEO_FX_color[1], NEO_FX_color[2]);
+  return 1;
+}
+
+#if NEO_FX_FIRE > 0
+// Fire: get cooled down heat value
+static inline uint8_t NEO_FX_cool(uint8_t heat) {
+  uint8_t cool = NEO_FX_randomMax(NEO_FX_state.fire.cooling);
+  return (cool < heat) ? heat - cool : 0;
+}
+
+// Fire: write heat color of a pixel if its heat has changed
+static uint8_t NEO_FX_heatPixel(uint16_t pixel, uint8_t heat) {
+  uint8_t t, ramp;
+  if(heat == NEO_FX_heat[pixel]) return 0;
+  NEO_FX_heat[pixel] = heat;
+  t    = ((uint16_t)heat * 192) >> 8;         // scale heat to 0..191
+  ramp = (t & 63) << 2;                       // brightness within heat band
+  if(t & 0x80)      NEO_writeRGB(pixel, 255, 255, ramp);  // hottest: yellow-white
+  else if(t & 0x40) NEO_writeRGB(pixel, 255, ramp, 0);    // middle: red-yellow
+  else              NEO_writeRGB(pixel, ramp, 0, 0);      // coolest: black-red
+  return 1;
+}
+
+// Fire: cool down, let heat rise and drift, ignite sparks near the bottom
+static uint8_t NEO_FX_fireStep(void) {
+  uint16_t k;
+  uint8_t  c1, c2, c3, spark, changed = 0;
+
+  // Heat of pixel k is drifted from the cooled pixels k-1 and k-2. Going from top to
+  // bottom each cooled value is calculated once and used for two pixels.
+  c1 = NEO_FX_cool(NEO_FX_heat[NEO_COUNT - 2]);
+  c2 = NEO_FX_cool(NEO_FX_heat[NEO_COUNT - 3]);
+  c3 = c1;
+  for(k=NEO_COUNT-1; k>=2; k--) {
+    changed |= NEO_FX_heatPixel(k, ((uint16_t)c1 + c2 + c2) * 85 >> 8);
+    c3 = c1; c1 = c2;
+    if(k >= 3) c2 = NEO_FX_cool(NEO_FX_heat[k - 3]);
+  }
+  changed |= NEO_FX_heatPixel(1, c3);         // lowest pixels are only cooled
+  changed |= NEO_FX_heatPixel(0, c1);
+
+  // Randomly ignite new spark near the bottom
+  if(NEO_FX_random() < NEO_FX_state.fire.sparking) {
+    k = NEO_FX_randomMax(NEO_COUNT < 7 ? NEO_COUNT : 7);
+    spark = 160 + NEO_FX_randomMax(96);
+    spark = (NEO_FX_heat[k] > 255 - spark) ? 255 : NEO_FX_heat[k] + spark;
+    changed |= NEO_FX_heatPixel(k, spark);
+  }
+  return changed;
+}
+#endif
+
+// Rainbow: every pixel changes, hues are calculated incrementally
+static uint8_t NEO_FX_rainbowStep(void) {
+  uint16_t i;
+  uint8_t  hue = NEO_FX_state.rainbow.hue;
+  for(i=0; i<NEO_COUNT; i++, hue+=NEO_FX_state.rainbow.spread) NEO_writeHSV(i, hue, 255, 255);
+  NEO_FX_state.rainbow.hue += NEO_FX_state.rainbow.speed;
+  if(!NEO_FX_state.rainbow.speed) NEO_FX_effect = NEO_FX_NONE;          // static rainbow
+  return 1;
+}
+
+// ===================================================================================
+// Effects Engine Control
+// ===================================================================================
+
+// Init NeoPixels, brightness and frame timer
+void NEO_FX_init(void) {
+  NEO_init();
+  NEO_setBrightness(255);
+  NEO_FX_next = NEO_FX_ticks();
+}
+
+// Render frame if due, returns NEO_FX_IDLE, NEO_FX_OK or NEO_FX_LATE
+uint8_t NEO_FX_poll(void) {
+  uint8_t  changed = 0;
+  uint32_t start = NEO_FX_ticks();
+  if((int32_t)(start - NEO_FX_next) < 0) return NEO_FX_IDLE;
+
+  // Schedule next frame, count frames which could not be started at all
+  NEO_FX_ok = 1;
+  NEO_FX_next += NEO_FX_PERIOD;
+  while((int32_t)(start - NEO_FX_next) >= 0) {
+    NEO_FX_next += NEO_FX_PERIOD;
+    NEO_FX_missed++;
+    NEO_FX_ok = 0;
+  }
+
+  // Advance effect by one step and update pixels if necessary
+  switch(NEO_FX_effect) {
+    case NEO_FX_FADE:     changed = NEO_FX_fadeStep();    break;
+    case NEO_FX_CHASE:    changed = NEO_FX_chaseStep();   break;
+    #if NEO_FX_FIRE > 0
+    case NEO_FX_FIRE_ON:  changed = NEO_FX_fireStep();    break;
+    #endif
+    case NEO_FX_RAINBOW:  changed = NEO_FX_rainbowStep(); break;
+    default:              break;
+  }
+  if(changed || NEO_FX_dirty) NEO_update();
+  NEO_FX_dirty = 0;
+
+  // Frame time instrumentation
+  NEO_FX_time = NEO_FX_ticks() - start;
+  NEO_FX_count++;
+  if(NEO_FX_ok && ((int32_t)(NEO_FX_ticks() - NEO_FX_next) >= 0)) {
+    NEO_FX_missed++;
+    NEO_FX_ok = 0;
+  }
+  return NEO_FX_ok ? NEO_FX_OK : NEO_FX_LATE;
+}
+
+// Stop current effect (pixels keep their colors)
+void NEO_FX_stop(void) {
+  NEO_FX_effect = NEO_FX_NONE;
+}
+
+// ===================================================================================
+// Start Effects
+// ===================================================================================
+
+// Fade all pixels from current solid color to color r,g,b within n frames, a running
+// fade is continued from the color reached so far
+void NEO_FX_fade(uint8_t r, uint8_t g, uint8_t b, uint16_t frames) {
+  uint8_t i, target[3] = {r, g, b};
+  int32_t start;
+  if(!frames) frames = 1;
+  for(i=0; i<3; i++) {
+    if(NEO_FX_effect == NEO_FX_FADE) start = NEO_FX_state.fade.value[i];
+    else start = (int32_t)NEO_FX_color[i] << 8;
+    NEO_FX_state.fade.value[i]  = start;
+    NEO_FX_state.fade.step[i]   = (((int32_t)target[i] << 8) - start) / frames;
+    NEO_FX_state.fade.out[i]    = ~NEO_lut[start >> 8];       // force first write
+    NEO_FX_state.fade.target[i] = target[i];
+  }
+  NEO_FX_state.fade.frames = frames;
+  NEO_FX_effect = NEO_FX_FADE;
+}
+
+// Every s-th pixel lit with color r,g,b, moving one pixel every n frames
+void NEO_FX_chase(uint8_t r, uint8_t g, uint8_t b, uint8_t spacing, uint8_t frames) {
+  NEO_FX_color[0] = r; NEO_FX_color[1] = g; NEO_FX_color[2] = b;
+  NEO_FX_fill(0, 0, 0);
+  NEO_FX_state.chase.spacing = spacing ? spacing : 1;
+  NEO_FX_state.chase.pos     = NEO_FX_state.chase.spacing - 1;     // first step -> 0
+  NEO_FX_state.chase.frames  = frames ? frames : 1;
+  NEO_FX_state.chase.count   = 1;
+  NEO_FX_dirty = 1;
+  NEO_FX_effect = NEO_FX_CHASE;
+}
+
+#if NEO_FX_FIRE > 0
+// Fire simulation with cooling (0..255) and sparking (0..255)
+void NEO_FX_fire(uint8_t cooling, uint8_t sparking) {
+  uint16_t i;
+  for(i=0; i<NEO_COUNT; i++) NEO_FX_heat[i] = 0;
+  NEO_FX_fill(0, 0, 0);
+  NEO_FX_color[0] = 0; NEO_FX_color[1] = 0; NEO_FX_color[2] = 0;
+  NEO_FX_state.fire.cooling  = cooling;
+  NEO_FX_state.fire.sparking = sparking;
+  NEO_FX_dirty = 1;
+  NEO_FX_effect = NEO_FX_FIRE_ON;
+}
+#endif
+
+// Rainbow moving with speed (hue change per frame) and spread (hue between pixels)
+void NEO_FX_rainbow(uint8_t speed, uint8_t spread) {
+  NEO_FX_state.rainbow.hue    = 0;
+  NEO_FX_state.rainbow.speed  = speed;
+  NEO_FX_state.rainbow.spread = spread;
+  NEO_FX_effect = NEO_FX_RAINBOW;
+}
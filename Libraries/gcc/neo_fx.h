@@ -0,0 +1,88 @@
+// ===================================================================================
+// NeoPixel Effects Engine with fixed Frame Rate                              * v1.0 *
+// ===================================================================================
+//
+// Effects are incremental state machines, advanced by one step per frame. Only the
+// pixels that actually change are written (re-encoded) into the NeoPixel buffer and
+// the string is only updated if something has changed. Frames are scheduled at a
+// fixed rate from a free running timer, the string update is started at the end of
+// each frame (NEO_update() waits for the latch of the previous frame).
+//
+// Functions available:
+// --------------------
+// NEO_FX_init()            init NeoPixels, brightness and frame timer
+// NEO_FX_poll()            call frequently from main loop, renders frame if due;
+//                          returns NEO_FX_IDLE, NEO_FX_OK or NEO_FX_LATE
+// NEO_FX_stop()            stop current effect (pixels keep their colors)
+// NEO_FX_fade(r,g,b,n)     fade all pixels to color r,g,b within n frames
+// NEO_FX_chase(r,g,b,s,n)  every s-th pixel lit with r,g,b, moving every n frames
+// NEO_FX_fire(c,s)         fire with max cooling c per frame and sparking chance s
+// NEO_FX_rainbow(v,d)      rainbow moving with speed v, hue distance d between pixels
+//
+// NEO_FX_frameTime()       ticks used by the last frame (render and update start)
+// NEO_FX_deadlineMet()     1 if last frame was finished before the next was due
+// NEO_FX_missedFrames()    number of frames which missed their deadline
+// NEO_FX_frames()          number of frames rendered
+//
+// Notes:
+// ------
+// - Uses neo_color, choose the NeoPixel library there.
+// - The frame timer defaults to the free running SysTick counter of the CH32V
+//   families (STK->CNT at F_CPU). On other MCUs define NEO_FX_ticks() as a free
+//   running 32-bit up-counter and NEO_FX_TICKS_PER_SEC accordingly (e.g. MIL_read()
+//   and 1000).
+// - The frame period must be longer than the transmission time of the string
+//   (about 30us per pixel), since the buffer is written during the next frame.
+// - The fire effect needs NEO_COUNT bytes of RAM, it can be removed by setting
+//   NEO_FX_FIRE to 0.
+//
+// 2023 by Stefan Wagner:   https://github.com/wagiminator
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "neo_color.h"
+
+// Effects engine parameters
+#define NEO_FX_FPS            50          // frames per second
+#define NEO_FX_FIRE           1           // 1: include fire effect (NEO_COUNT bytes RAM)
+
+#ifndef NEO_FX_ticks
+#define NEO_FX_ticks()        (STK->CNT)  // free running frame timer (32-bit up)
+#define NEO_FX_TICKS_PER_SEC  F_CPU       // frame timer ticks per second
+#endif
+
+#define NEO_FX_PERIOD         (NEO_FX_TICKS_PER_SEC / NEO_FX_FPS) // ticks per frame
+
+// Return values of NEO_FX_poll()
+#define NEO_FX_IDLE           0           // no frame due
+#define NEO_FX_OK             1           // frame rendered, deadline met
+#define NEO_FX_LATE           2           // frame rendered, deadline missed
+
+// Effects engine variables
+extern uint32_t NEO_FX_time;              // ticks used by last frame
+extern uint32_t NEO_FX_count;             // number of frames rendered
+extern uint16_t NEO_FX_missed;            // number of frames missed their deadline
+extern uint8_t  NEO_FX_ok;                // last frame met its deadline
+
+// Effects engine functions
+void NEO_FX_init(void);                                                     // init
+uint8_t NEO_FX_poll(void);                                                  // render frame if due
+void NEO_FX_stop(void);                                                     // stop effect
+void NEO_FX_fade(uint8_t r, uint8_t g, uint8_t b, uint16_t frames);         // fade to color
+void NEO_FX_chase(uint8_t r, uint8_t g, uint8_t b, uint8_t spacing, uint8_t frames);
+void NEO_FX_fire(uint8_t cooling, uint8_t sparking);                        // fire
+void NEO_FX_rainbow(uint8_t speed, uint8_t spread);                         // rainbow
+
+// Effects engine macros
+#define NEO_FX_frameTime()    (NEO_FX_time)       // ticks used by last frame
+#define NEO_FX_deadlineMet()  (NEO_FX_ok)         // last frame in time?
+#define NEO_FX_missedFrames() (NEO_FX_missed)     // number of missed deadlines
+#define NEO_FX_frames()       (NEO_FX_count)      // number of frames rendered
+
+#ifdef __cplusplus
+};
+#endif
@@ -1,5 +1,5 @@
 // ===================================================================================
-// nRF24L01+ Functions                                                        * v1.0 *
+// nRF24L01+ Functions                                                        * v1.1 *
 // ===================================================================================
 //
 // 2023 by Stefan Wagner:   https://github.com/wagiminator
@@ -60,7 +60,12 @@ void NRF_writeBuffer(uint8_t reg, uint8_t *buf, uint8_t len) {
   if(reg < 0x20) reg += 0x20;
   PIN_low(PIN_CSN);
   SPI_transfer(reg);
+  #if defined(SPI_DMA) && SPI_DMA > 0
+  SPI_writeBuffer(buf, len);
+  SPI_DMA_wait();
+  #else
   while(len--) SPI_transfer(*buf++);
+  #endif
   PIN_high(PIN_CSN);
 }
 
@@ -68,7 +73,12 @@ void NRF_writeBuffer(uint8_t reg, uint8_t *buf, uint8_t len) {
 void NRF_readBuffer(uint8_t reg, uint8_t *buf, uint8_t len) {
   PIN_low(PIN_CSN);
   SPI_transfer(reg);
+  #if defined(SPI_DMA) && SPI_DMA > 0
+  SPI_readBuffer(buf, len);
+  SPI_DMA_wait();
+  #else
   while(len--) *buf++ = SPI_transfer(0);
+  #endif
   PIN_high(PIN_CSN);
 }
 
@@ -1,5 +1,5 @@
 // ===================================================================================
-// nRF24L01+ Functions                                                        * v1.0 *
+// nRF24L01+ Functions                                                        * v1.1 *
 // ===================================================================================
 //
 // Collection of the most necessary functions for controlling an nRF24L01+.
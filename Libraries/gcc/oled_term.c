@@ -1,5 +1,5 @@
 // ===================================================================================
-// SSD1306 128x64 Pixels OLED Terminal Functions                              * v1.1 *
+// SSD1306 128x64 Pixels OLED Terminal Functions                              * v1.2 *
 // ===================================================================================
 //
 // Collection of the most necessary functions for controlling an SSD1306 128x64 pixels
@@ -191,3 +191,27 @@ void OLED_write(char c) {
     OLED_setline((line + scroll) & 0x07);
   }
 }
+
+// OLED write buffer, printable characters of the same line are sent in one transmission
+void OLED_writeBuffer(const char* buf, uint16_t len) {
+  uint8_t i;
+  uint16_t ptr;
+  while(len) {
+    if(((*buf & 0x7f) < 32) || (column >= 20)) {  // control character or end of line?
+      OLED_write(*buf++);                         // -> handle it by OLED_write
+      len--;
+      continue;
+    }
+    I2C_start(OLED_ADDR << 1);                    // start transmission to OLED
+    I2C_write(OLED_DAT_MODE);                     // set data mode
+    while(len && (column < 20) && ((*buf & 0x7f) >= 32)) {
+      ptr = (*buf++ & 0x7f) - 32;                 // character pointer
+      ptr += ptr << 2;                            // -> ptr = (ch - 32) * 5;
+      I2C_write(0x00);                            // write space between characters
+      for(i=5; i; i--) I2C_write(OLED_FONT[ptr++]); // write character
+      column++;
+      len--;
+    }
+    I2C_stop();                                   // stop transmission
+  }
+}
@@ -1,5 +1,5 @@
 // ===================================================================================
-// SSD1306 128x64 Pixels OLED Terminal Functions                              * v1.1 *
+// SSD1306 128x64 Pixels OLED Terminal Functions                              * v1.2 *
 // ===================================================================================
 //
 // Collection of the most necessary functions for controlling an SSD1306 128x64 pixels
@@ -13,10 +13,13 @@
 // OLED_invert(v)           Invert display (0: inverse off, 1: inverse on)
 // OLED_clear()             Clear screen of OLED display
 // OLED_write(c)            Write a character or handle control characters
+// OLED_writeBuffer(b,n)    Write buffer (b) with length (n), printable characters of the
+//                          same line are sent within one I2C transmission
 //
 // If print functions are activated (see below, print.h must be included):
 // -----------------------------------------------------------------------
-// OLED_printf(f, ...)      printf (supports %s, %c, %d, %u, %x, %b, %02d, %%)
+// OLED_printf(f, ...)      printf (supports %s, %c, %d, %u, %x, %b, %02d, %%),
+//                          sends the formatted string via OLED_writeBuffer
 // OLED_printD(n)           Print decimal value
 // OLED_printW(n)           Print 32-bit hex word value
 // OLED_printH(n)           Print 16-bit hex half-word value
@@ -91,6 +94,7 @@ void OLED_contrast(uint8_t val);  // Set display contrast (0-255)
 void OLED_invert(uint8_t val);    // Invert display (0: inverse off, 1: inverse on)
 void OLED_clear(void);            // OLED clear screen
 void OLED_write(char c);          // OLED write a character or handle control characters
+void OLED_writeBuffer(const char* buf, uint16_t len); // OLED write buffer
 
 // Additional print functions (if activated, see above)
 #if OLED_PRINT == 1
@@ -103,7 +107,7 @@ void OLED_write(char c);          // OLED write a character or handle control ch
 #define OLED_println(s)   println(OLED_write, s)  // print string with newline
 #define OLED_print        OLED_printS             // alias
 #define OLED_newline()    OLED_write('\n')        // send newline
-#define OLED_printf(f, ...)   printF(OLED_write, f, ##__VA_ARGS__)
+#define OLED_printf(f, ...)   printFB(OLED_writeBuffer, f, ##__VA_ARGS__)
 #endif
 
 #ifdef __cplusplus
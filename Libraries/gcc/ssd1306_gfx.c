@@ -1,5 +1,5 @@
 // ===================================================================================
-// SSD1306/SH1106 I2C OLED Graphics Functions                                 * v1.6 *
+// SSD1306/SH1106 I2C OLED Graphics Functions                                 * v2.0 *
 // ===================================================================================
 // 2024 by Stefan Wagner:   https://github.com/wagiminator
 
@@ -8,17 +8,82 @@
 // ===================================================================================
 // Screen Buffer
 // ===================================================================================
-uint8_t __attribute__ ((aligned(4))) OLED_buffer[OLED_WIDTH * OLED_HEIGHT / 8];
+#define OLED_PAGES_CNT  (OLED_HEIGHT / 8)
+
+// Pages held by the buffer (first/last); in band mode only the current page
+#if OLED_BANDED > 0
+  uint8_t OLED_band;
+  #define OLED_BUF_PAGES  1
+  #define OLED_BAND_FIRST OLED_band
+  #define OLED_BAND_LAST  OLED_band
+#else
+  #define OLED_BUF_PAGES  OLED_PAGES_CNT
+  #define OLED_BAND_FIRST 0
+  #define OLED_BAND_LAST  (OLED_PAGES_CNT - 1)
+#endif
+
+// Buffer index of column x in page p
+#define OLED_INDEX(p, x)  (((p) - OLED_BAND_FIRST) * OLED_WIDTH + (x))
+
+uint8_t __attribute__ ((aligned(4))) OLED_buffer[OLED_WIDTH * OLED_BUF_PAGES];
 
 #if OLED_DOUBLEBUF == 0
   #define OLED_drawbuffer OLED_buffer
   #define OLED_sendbuffer OLED_buffer
 #else
-  uint8_t __attribute__ ((aligned(4))) OLED_buffer2[OLED_WIDTH * OLED_HEIGHT / 8];
+  uint8_t __attribute__ ((aligned(4))) OLED_buffer2[OLED_WIDTH * OLED_BUF_PAGES];
   uint8_t* OLED_drawbuffer = OLED_buffer;
   uint8_t* OLED_sendbuffer = OLED_buffer2;
 #endif
 
+// ===================================================================================
+// Dirty Page Tracking
+// ===================================================================================
+
+#if OLED_BANDED == 0
+// Changed column range of each page (first > last: page unchanged)
+uint8_t OLED_dirty_first[OLED_PAGES_CNT];
+uint8_t OLED_dirty_last[OLED_PAGES_CNT];
+
+// Mark columns x0..x1 of page p as changed
+static inline void OLED_markDirty(uint8_t p, uint8_t x0, uint8_t x1) {
+  if(x0 < OLED_dirty_first[p]) OLED_dirty_first[p] = x0;
+  if(x1 > OLED_dirty_last[p])  OLED_dirty_last[p]  = x1;
+}
+
+// Mark all pages as unchanged
+static void OLED_markClean(void) {
+  for(uint8_t p=0; p<OLED_PAGES_CNT; p++) {
+    OLED_dirty_first[p] = 0xFF;
+    OLED_dirty_last[p]  = 0;
+  }
+}
+
+#if OLED_ASYNC == 0
+// Check if whole screen is marked as changed
+static uint8_t OLED_isInvalid(void) {
+  for(uint8_t p=0; p<OLED_PAGES_CNT; p++) {
+    if(OLED_dirty_first[p] || (OLED_dirty_last[p] != OLED_WIDTH - 1)) return 0;
+  }
+  return 1;
+}
+#endif
+
+// Mark whole screen as changed
+void OLED_invalidate(void) {
+  for(uint8_t p=0; p<OLED_PAGES_CNT; p++) {
+    OLED_dirty_first[p] = 0;
+    OLED_dirty_last[p]  = OLED_WIDTH - 1;
+  }
+}
+
+#else
+// Band mode always sends whole pages, nothing to track
+#define OLED_markDirty(p, x0, x1)
+#define OLED_markClean()
+void OLED_invalidate(void) {}
+#endif
+
 // ===================================================================================
 // Standard ASCII 5x8 Font (chars 32 - 127)
 // ===================================================================================
@@ -173,6 +238,7 @@ void OLED_init(void) {
   I2C_write(OLED_CMD_MODE);                       // set command mode
   I2C_writeBuffer((uint8_t*)OLED_INIT_CMD, sizeof(OLED_INIT_CMD)); // send the command bytes
   I2C_stop();                                     // stop transmission
+  OLED_invalidate();                              // screen content is unknown
 }
 
 // Switch display on/off (0: display off, 1: display on)
@@ -228,7 +294,23 @@ void OLED_home(uint8_t x, uint8_t y) {
   I2C_stop();                                     // stop transmission
 }
 
-// Refresh screen buffer (send buffer via I2C)
+#if OLED_SH1106 == 0 && OLED_WIDTH != 64
+// Set column and page address window (horizontal addressing mode)
+void OLED_window(uint8_t x0, uint8_t x1, uint8_t p0, uint8_t p1) {
+  I2C_start(OLED_ADDR << 1);                      // start transmission to OLED
+  I2C_write(OLED_CMD_MODE);                       // set command mode
+  I2C_write(OLED_COLUMNS);                        // set start and end column
+  I2C_write(OLED_XOFF + x0);
+  I2C_write(OLED_XOFF + x1);
+  I2C_write(OLED_PAGES);                          // set start and end page
+  I2C_write(p0);
+  I2C_write(p1);
+  I2C_stop();                                     // stop transmission
+}
+#endif
+
+#if OLED_BANDED == 0 && OLED_ASYNC == 0
+// Refresh screen buffer (send changed parts of buffer via I2C)
 void OLED_refresh(void) {
   #if OLED_DOUBLEBUF > 0
   uint8_t* temp = OLED_drawbuffer;                // switch buffers
@@ -236,32 +318,177 @@ void OLED_refresh(void) {
   OLED_sendbuffer = temp;
   #endif
 
-  #if OLED_SH1106 == 1 || OLED_WIDTH == 64
-  uint8_t* buffer = OLED_sendbuffer;
-  for(uint8_t y=0; y<OLED_HEIGHT; y+=8) {         // each page must be transmitted individually
-    OLED_home(OLED_XOFF, OLED_YOFF + y);          // set page
+  #if OLED_SH1106 == 0 && OLED_WIDTH != 64
+  if(OLED_isInvalid()) {                          // whole screen changed?
+    OLED_window(0, OLED_WIDTH - 1, 0, OLED_PAGES_CNT - 1);
+    I2C_start(OLED_ADDR << 1);                    // start transmission to OLED
+    I2C_write(OLED_DAT_MODE);                     // set data mode
+    I2C_writeBuffer(OLED_sendbuffer, sizeof(OLED_buffer)); // send screen buffer using DMA
+    #if OLED_DOUBLEBUF == 0
+    OLED_markClean();
+    #endif
+    return;
+  }
+  #endif
+
+  for(uint8_t p=0; p<OLED_PAGES_CNT; p++) {       // send changed segment of each page
+    uint8_t x0 = OLED_dirty_first[p];
+    uint8_t x1 = OLED_dirty_last[p];
+    if(x0 > x1) continue;                         // page unchanged
+    #if OLED_SH1106 == 1 || OLED_WIDTH == 64
+    OLED_home(OLED_XOFF + x0, OLED_YOFF + (p << 3)); // set page and column
+    #else
+    OLED_window(x0, x1, p, p);                    // set column window
+    #endif
     I2C_start(OLED_ADDR << 1);                    // start transmission to OLED
-    I2C_write(OLED_DAT_MODE);                     // set command mode
-    I2C_writeBuffer(buffer, OLED_WIDTH);          // transmit page
-    buffer += OLED_WIDTH;                         // increase buffer pointer
+    I2C_write(OLED_DAT_MODE);                     // set data mode
+    I2C_writeBuffer(OLED_sendbuffer + p * OLED_WIDTH + x0, x1 - x0 + 1);
   }
+
+  // In double-buffer mode the new draw buffer still contains the previous frame,
+  // it differs from the screen only in the segments just sent.
+  #if OLED_DOUBLEBUF == 0
+  OLED_markClean();
+  #endif
+}
+
+#elif OLED_BANDED == 0
+// Asynchronous refresh: chain of I2C transactions, each started by the callback of
+// the previous one (page address command, page data, next page address command, ...)
+static uint8_t OLED_send_first[OLED_PAGES_CNT];   // column range of each page to send
+static uint8_t OLED_send_last[OLED_PAGES_CNT];
+static uint8_t OLED_send_cmd[6];                  // page address command bytes
+static uint8_t OLED_send_page;                    // first page of current block
+static uint8_t OLED_send_end;                     // last page of current block
+static uint8_t OLED_send_data;                    // 1: address set, send data next
+volatile uint8_t OLED_sending;                    // 1: refresh in progress
+
+// Check if page p has to be sent completely
+#define OLED_sendFull(p)  (!OLED_send_first[p] && (OLED_send_last[p] == OLED_WIDTH - 1))
+
+// Abort refresh chain, send everything next time
+static void OLED_sendAbort(void) {
+  OLED_invalidate();
+  OLED_sending = 0;
+}
+
+// Start next transaction of the refresh chain (called from I2C interrupt)
+static void OLED_sendNext(uint8_t status) {
+  uint8_t p = OLED_send_page;
+  if(status != I2C_OK) {                          // transaction failed?
+    OLED_sendAbort();
+    return;
+  }
+
+  // Address is set -> send data of pages p..end
+  if(OLED_send_data) {
+    OLED_send_data = 0;
+    OLED_send_page = OLED_send_end + 1;
+    if(!I2C_transferCmd(OLED_ADDR << 1, OLED_DAT_MODE,
+                        OLED_sendbuffer + p * OLED_WIDTH + OLED_send_first[p],
+                        (OLED_send_end - p) * OLED_WIDTH
+                        + OLED_send_last[OLED_send_end] - OLED_send_first[p] + 1,
+                        0, 0, OLED_sendNext)) OLED_sendAbort();   // I2C used by others
+    return;
+  }
+
+  // Find next changed page, refresh is finished if there is none
+  while((p < OLED_PAGES_CNT) && (OLED_send_first[p] > OLED_send_last[p])) p++;
+  if(p >= OLED_PAGES_CNT) {
+    OLED_sending = 0;
+    return;
+  }
+
+  // Set address of next block
+  uint8_t end = p;
+  uint8_t len = 3;
+  #if OLED_SH1106 == 0 && OLED_WIDTH != 64
+  len = 6;
+  if(OLED_sendFull(p)) {                          // following full pages in one go
+    while((end < OLED_PAGES_CNT - 1) && OLED_sendFull(end + 1)) end++;
+  }
+  OLED_send_cmd[0] = OLED_COLUMNS;                // set start and end column
+  OLED_send_cmd[1] = OLED_XOFF + OLED_send_first[p];
+  OLED_send_cmd[2] = OLED_XOFF + OLED_send_last[p];
+  OLED_send_cmd[3] = OLED_PAGES;                  // set start and end page
+  OLED_send_cmd[4] = p;
+  OLED_send_cmd[5] = end;
   #else
-  OLED_home(OLED_XOFF, OLED_YOFF);                // set start address
-  I2C_start(OLED_ADDR << 1);                      // start transmission to OLED
-  I2C_write(OLED_DAT_MODE);                       // set command mode
-  I2C_writeBuffer(OLED_sendbuffer, sizeof(OLED_buffer)); // send screen buffer using DMA
+  uint8_t x = OLED_XOFF + OLED_send_first[p];
+  OLED_send_cmd[0] = OLED_PAGE | ((OLED_YOFF >> 3) + p); // set page
+  OLED_send_cmd[1] = OLED_COLUMN_LOW  | (x & 0xf);       // set column
+  OLED_send_cmd[2] = OLED_COLUMN_HIGH | (x >> 4);
   #endif
+  OLED_send_page = p;
+  OLED_send_end  = end;
+  OLED_send_data = 1;
+  if(!I2C_transferCmd(OLED_ADDR << 1, OLED_CMD_MODE, OLED_send_cmd, len,
+                      0, 0, OLED_sendNext)) OLED_sendAbort();     // I2C used by others
 }
 
+// Refresh screen buffer (start sending changed parts of buffer, doesn't wait)
+void OLED_refresh(void) {
+  while(OLED_sending || I2C_transferBusy());     // wait for previous refresh
+  #if OLED_DOUBLEBUF > 0
+  uint8_t* temp = OLED_drawbuffer;                // switch buffers
+  OLED_drawbuffer = OLED_sendbuffer;
+  OLED_sendbuffer = temp;
+  #endif
+
+  for(uint8_t p=0; p<OLED_PAGES_CNT; p++) {       // take over changed segments
+    OLED_send_first[p] = OLED_dirty_first[p];
+    OLED_send_last[p]  = OLED_dirty_last[p];
+  }
+
+  // In double-buffer mode the new draw buffer still contains the previous frame,
+  // it differs from the screen only in the segments just sent.
+  #if OLED_DOUBLEBUF == 0
+  OLED_markClean();
+  #endif
+
+  OLED_send_page = 0;                             // start the chain
+  OLED_send_data = 0;
+  OLED_sending   = 1;
+  OLED_sendNext(I2C_OK);
+}
+
+#else
+// Render screen band by band: clear band buffer, call draw(), send page
+void OLED_render(void (*draw)(void)) {
+  #if OLED_SH1106 == 0 && OLED_WIDTH != 64
+  OLED_window(0, OLED_WIDTH - 1, 0, OLED_PAGES_CNT - 1); // pages follow each other
+  #endif
+  for(OLED_band=0; OLED_band<OLED_PAGES_CNT; OLED_band++) {
+    #if OLED_DOUBLEBUF == 0 && defined(I2C_busy)
+    while(I2C_busy());                            // previous band still on the wire
+    #endif
+    OLED_clear();                                 // clear band buffer
+    draw();                                       // draw everything, clipped to band
+    #if OLED_DOUBLEBUF > 0
+    uint8_t* temp = OLED_drawbuffer;              // switch buffers
+    OLED_drawbuffer = OLED_sendbuffer;
+    OLED_sendbuffer = temp;
+    #endif
+    #if OLED_SH1106 == 1 || OLED_WIDTH == 64
+    OLED_home(OLED_XOFF, OLED_YOFF + (OLED_band << 3)); // set page
+    #endif
+    I2C_start(OLED_ADDR << 1);                    // start transmission to OLED
+    I2C_write(OLED_DAT_MODE);                     // set data mode
+    I2C_writeBuffer(OLED_sendbuffer, OLED_WIDTH); // send band
+  }
+}
+#endif
+
 // ===================================================================================
 // OLED Graphics Functions
 // ===================================================================================
 
-// Clear OLED screen buffer
+// Clear OLED screen buffer (whole words)
 void OLED_clear(void) {
   uint32_t* ptr = (uint32_t*)OLED_drawbuffer;
   uint32_t  cnt = sizeof(OLED_buffer) >> 2;
   while(cnt--) *ptr++ = (uint32_t)0;
+  OLED_invalidate();
 }
 
 // Copy OLED screen buffer
@@ -270,17 +497,26 @@ void OLED_copy(void) {
   uint32_t* dptr = (uint32_t*)OLED_drawbuffer;
   uint32_t  cnt  = sizeof(OLED_buffer) >> 2;
   while(cnt--) *dptr++ = *sptr++;
+  #if OLED_DOUBLEBUF > 0
+  OLED_markClean();                               // draw buffer equals screen now
+  #endif
 }
 
 // Get pixel color at (x,y) (0: pixel cleared, 1: pixel set)
 uint8_t OLED_getPixel(int16_t x, int16_t y) {
   #if OLED_PORTRAIT == 0
   if((x < 0) || (x >= OLED_WIDTH) || (y < 0) || (y >= OLED_HEIGHT)) return 0;
-  return((OLED_drawbuffer[((uint16_t)y >> 3) * OLED_WIDTH + x] >> (y & 7)) & 1);
+  #if OLED_BANDED > 0
+  if(((uint16_t)y >> 3) != OLED_band) return 0;   // outside of current band
+  #endif
+  return((OLED_drawbuffer[OLED_INDEX((uint16_t)y >> 3, x)] >> (y & 7)) & 1);
   #else
   x = (int16_t)(OLED_HEIGHT - 1) - x;
   if((x < 0) || (x >= OLED_HEIGHT) || (y < 0) || (y >= OLED_WIDTH)) return 0;
-  return((OLED_drawbuffer[((uint16_t)x >> 3) * OLED_WIDTH + y] >> (x & 7)) & 1);
+  #if OLED_BANDED > 0
+  if(((uint16_t)x >> 3) != OLED_band) return 0;   // outside of current band
+  #endif
+  return((OLED_drawbuffer[OLED_INDEX((uint16_t)x >> 3, y)] >> (x & 7)) & 1);
   #endif
 }
 
@@ -288,36 +524,104 @@ uint8_t OLED_getPixel(int16_t x, int16_t y) {
 void OLED_setPixel(int16_t x, int16_t y, uint8_t color) {
   #if OLED_PORTRAIT == 0
   if((x < 0) || (x >= OLED_WIDTH) || (y < 0) || (y >= OLED_HEIGHT)) return;
+  #if OLED_BANDED > 0
+  if(((uint16_t)y >> 3) != OLED_band) return;     // outside of current band
+  #endif
+  OLED_markDirty((uint16_t)y >> 3, x, x);
   switch(color) {
-    case 0: OLED_drawbuffer[((uint16_t)y >> 3) * OLED_WIDTH + x] &= ~((uint8_t)1 << (y & 7));
+    case 0: OLED_drawbuffer[OLED_INDEX((uint16_t)y >> 3, x)] &= ~((uint8_t)1 << (y & 7));
             break;
-    case 1: OLED_drawbuffer[((uint16_t)y >> 3) * OLED_WIDTH + x] |=  ((uint8_t)1 << (y & 7));
+    case 1: OLED_drawbuffer[OLED_INDEX((uint16_t)y >> 3, x)] |=  ((uint8_t)1 << (y & 7));
             break;
-    case 2: OLED_drawbuffer[((uint16_t)y >> 3) * OLED_WIDTH + x] ^=  ((uint8_t)1 << (y & 7));
+    case 2: OLED_drawbuffer[OLED_INDEX((uint16_t)y >> 3, x)] ^=  ((uint8_t)1 << (y & 7));
             break;
   }
   #else
   if((x < 0) || (x >= OLED_HEIGHT) || (y < 0) || (y >= OLED_WIDTH)) return;
   x = (int16_t)(OLED_HEIGHT - 1) - x;
+  #if OLED_BANDED > 0
+  if(((uint16_t)x >> 3) != OLED_band) return;     // outside of current band
+  #endif
+  OLED_markDirty((uint16_t)x >> 3, y, y);
   switch(color) {
-    case 0: OLED_drawbuffer[((uint16_t)x >> 3) * OLED_WIDTH + y] &= ~((uint8_t)1 << (x & 7));
+    case 0: OLED_drawbuffer[OLED_INDEX((uint16_t)x >> 3, y)] &= ~((uint8_t)1 << (x & 7));
             break;
-    case 1: OLED_drawbuffer[((uint16_t)x >> 3) * OLED_WIDTH + y] |=  ((uint8_t)1 << (x & 7));
+    case 1: OLED_drawbuffer[OLED_INDEX((uint16_t)x >> 3, y)] |=  ((uint8_t)1 << (x & 7));
             break;
-    case 2: OLED_drawbuffer[((uint16_t)x >> 3) * OLED_WIDTH + y] ^=  ((uint8_t)1 << (x & 7));
+    case 2: OLED_drawbuffer[OLED_INDEX((uint16_t)x >> 3, y)] ^=  ((uint8_t)1 << (x & 7));
             break;
   }
   #endif
 }
 
+// Fill buffer columns x0..x1 and rows y0..y1 with color (coordinates must be valid)
+// (whole bytes per page, only the first and last page need a mask)
+static void OLED_fillBlock(uint8_t x0, uint8_t x1, uint8_t y0, uint8_t y1, uint8_t color) {
+  uint8_t  p0  = y0 >> 3;
+  uint8_t  p1  = y1 >> 3;
+  uint8_t  w   = x1 - x0 + 1;
+  uint8_t  p   = p0;
+  #if OLED_BANDED > 0
+  if(p  < OLED_band) p  = OLED_band;              // clip to current band
+  if(p1 > OLED_band) p1 = OLED_band;
+  #endif
+  uint8_t* ptr = OLED_drawbuffer + OLED_INDEX(p, x0);
+  for(; p<=p1; p++, ptr+=OLED_WIDTH) {
+    uint8_t  mask = 0xFF;
+    uint8_t* dst  = ptr;
+    uint8_t  cnt  = w;
+    if(p == p0)        mask &= (uint8_t)(0xFF << (y0 & 7));
+    if(p == (y1 >> 3)) mask &= (uint8_t)(0xFF >> (7 - (y1 & 7)));
+    OLED_markDirty(p, x0, x1);
+    switch(color) {
+      case 0: if(mask == 0xFF) while(cnt--) *dst++  = 0x00;
+              else             while(cnt--) *dst++ &= ~mask;
+              break;
+      case 1: if(mask == 0xFF) while(cnt--) *dst++  = 0xFF;
+              else             while(cnt--) *dst++ |= mask;
+              break;
+      case 2: while(cnt--) *dst++ ^= mask;
+              break;
+    }
+  }
+}
+
+// Write 8 vertical pixels (bits, LSB on top) to buffer column x starting at row y
+// (pixels outside the screen are clipped)
+static void OLED_blitColumn(int16_t x, int16_t y, uint8_t bits) {
+  if((x < 0) || (x >= OLED_WIDTH) || (y <= -8) || (y >= OLED_HEIGHT)) return;
+  int16_t  p     = (y + 8) >> 3;                  // page below first row + 1
+  uint8_t  shift = y & 7;
+  uint8_t* ptr;
+  if((--p >= OLED_BAND_FIRST) && (p <= OLED_BAND_LAST)) { // upper part of the bits
+    ptr  = OLED_drawbuffer + OLED_INDEX(p, x);
+    *ptr = (*ptr & ~(uint8_t)(0xFF << shift)) | (bits << shift);
+    OLED_markDirty(p, x, x);
+  }
+  if(shift && (++p >= OLED_BAND_FIRST) && (p <= OLED_BAND_LAST)) { // lower part of the bits
+    ptr  = OLED_drawbuffer + OLED_INDEX(p, x);
+    *ptr = (*ptr & (uint8_t)(0xFF << shift)) | (bits >> (8 - shift));
+    OLED_markDirty(p, x, x);
+  }
+}
+
+// Draw 8 vertical pixels at (x,y) with colors of bits (LSB on top)
+static void OLED_drawByte(int16_t x, int16_t y, uint8_t bits) {
+  #if OLED_PORTRAIT == 0
+  OLED_blitColumn(x, y, bits);
+  #else
+  for(uint8_t i=8; i; i--, bits>>=1) OLED_setPixel(x, y++, bits & 1);
+  #endif
+}
+
 // Draw vertical line starting from (x,y), height (h), color (0: cleared, 1: set)
 void OLED_drawVLine(int16_t x, int16_t y, int16_t h, uint8_t color) {
-  for(int16_t i=y; i<y+h; i++) OLED_setPixel(x, i, color);
+  OLED_fillRect(x, y, 1, h, color);
 }
 
 // Draw horizontal line starting from (x,y), width (w), color (0: cleared, 1: set)
 void OLED_drawHLine(int16_t x, int16_t y, int16_t w, uint8_t color) {
-  for(int16_t i=x; i<x+w; i++) OLED_setPixel(i, y, color);
+  OLED_fillRect(x, y, w, 1, color);
 }
 
 // Draw line from position (x0,y0) to (x1,y1) with color (0: cleared, 1: set)
@@ -356,7 +660,23 @@ void OLED_drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t color) {
 
 // Draw filled rectangle starting from (x,y), width (w), height (h), color
 void OLED_fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t color) {
-  for(int16_t i=x; i<x+w; i++) OLED_drawVLine(i, y, h, color);
+  int16_t x1 = x + w - 1;
+  int16_t y1 = y + h - 1;
+  #if OLED_PORTRAIT == 0
+  if(x < 0) x = 0;
+  if(y < 0) y = 0;
+  if(x1 >= OLED_WIDTH)  x1 = OLED_WIDTH  - 1;
+  if(y1 >= OLED_HEIGHT) y1 = OLED_HEIGHT - 1;
+  if((x > x1) || (y > y1)) return;
+  OLED_fillBlock(x, x1, y, y1, color);
+  #else
+  if(x < 0) x = 0;
+  if(y < 0) y = 0;
+  if(x1 >= OLED_HEIGHT) x1 = OLED_HEIGHT - 1;
+  if(y1 >= OLED_WIDTH)  y1 = OLED_WIDTH  - 1;
+  if((x > x1) || (y > y1)) return;
+  OLED_fillBlock(y, y1, (OLED_HEIGHT - 1) - x1, (OLED_HEIGHT - 1) - x, color);
+  #endif
 }
 
 // Draw circle, center at position (x0,y0), radius (r), color (0: cleared, 1: set)
@@ -421,21 +741,17 @@ void OLED_fillCircle(int16_t x0, int16_t y0, int16_t r, uint8_t color) {
 
 // Draw a complete screen
 void OLED_drawScreen(const uint8_t* bmp) {
-  uint32_t* ptr1 = (uint32_t*)bmp;
-  uint32_t* ptr2 = (uint32_t*)OLED_buffer;
+  uint32_t* ptr1 = (uint32_t*)(bmp + OLED_BAND_FIRST * OLED_WIDTH);
+  uint32_t* ptr2 = (uint32_t*)OLED_drawbuffer;
   uint32_t  cnt = sizeof(OLED_buffer) >> 2;
   while(cnt--) *ptr2++ = *ptr1++;
+  OLED_invalidate();
 }
 
 // Draw bitmap at position (x0,y0), width (w), hight (h), pointer to bitmap (*bmp)
 void OLED_drawBitmap(int16_t x0, int16_t y0, int16_t w, int16_t h, const uint8_t* bmp) {
   for(int16_t y=y0; y<y0+h; y+=8) {
-    for(int16_t x=x0; x<x0+w; x++) {
-      uint8_t line = *bmp++;
-      for(int16_t i=y; i<y+8; i++, line>>=1) {
-        OLED_setPixel(x, i, line & 1);
-      }
-    }
+    for(int16_t x=x0; x<x0+w; x++) OLED_drawByte(x, y, *bmp++);
   }
 }
 
@@ -492,16 +808,15 @@ void OLED_write(char c) {
     // Standard character, if necessary enlarged
     if(OLED_cs <= 8) {
       for(uint8_t i=6; i; i--) {
-        uint8_t line, col;
+        uint8_t line;
         int16_t y1 = OLED_cy;
         line = OLED_FONT[ptr++];
         if(i == 1) line = 0;
         if(OLED_ci) line = ~line;
-        for(uint8_t j=0; j<8; j++, line>>=1) {
-          col = line & 1;
-          if(OLED_cs == 1) OLED_setPixel(OLED_cx, y1++, col);
-          else {
-            OLED_fillRect(OLED_cx, y1, OLED_cs, OLED_cs, col);
+        if(OLED_cs == 1) OLED_drawByte(OLED_cx, y1, line);
+        else {
+          for(uint8_t j=0; j<8; j++, line>>=1) {
+            OLED_fillRect(OLED_cx, y1, OLED_cs, OLED_cs, line & 1);
             y1 += OLED_cs;
           }
         }
@@ -529,15 +844,14 @@ void OLED_write(char c) {
             }
           }
         }
-        int16_t y1 = OLED_cy;
         if(OLED_ci) {
           col0L = ~col0L;
           col0R = ~col0R;
         }
-        for(int8_t i=16; i; i--, col0L>>=1, col0R>>=1) {
-          OLED_setPixel(OLED_cx,   y1,   col0L & 1);
-          OLED_setPixel(OLED_cx+1, y1++, col0R & 1);
-        }
+        OLED_drawByte(OLED_cx,   OLED_cy,     col0L);
+        OLED_drawByte(OLED_cx,   OLED_cy + 8, col0L >> 8);
+        OLED_drawByte(OLED_cx+1, OLED_cy,     col0R);
+        OLED_drawByte(OLED_cx+1, OLED_cy + 8, col0R >> 8);
         col0 = col1; col0L = col1L; col0R = col1R; OLED_cx += 2;
       }
       OLED_fillRect(OLED_cx, OLED_cy, 2, 16, OLED_ci);
@@ -549,12 +863,10 @@ void OLED_write(char c) {
     for(uint8_t col=6; col; col--) {
       uint8_t col0 = OLED_FONT[ptr++];
       if(col == 1) col0 = 0;
-      if(OLED_ci) col0 = ~col0;
-      int16_t y1 = OLED_cy;
-      for(uint8_t i=8; i; i--, col0>>=1) {
-        OLED_setPixel(OLED_cx, y1++, col0 & 1);
-        OLED_setPixel(OLED_cx, y1++, col0 & 1);
-      }
+      uint16_t col0S = OLED_stretch(col0);
+      if(OLED_ci) col0S = ~col0S;
+      OLED_drawByte(OLED_cx, OLED_cy,     col0S);
+      OLED_drawByte(OLED_cx, OLED_cy + 8, col0S >> 8);
       OLED_cx++;
     }
     return;
@@ -1,5 +1,5 @@
 // ===================================================================================
-// SSD1306/SH1106 I2C OLED Graphics Functions                                 * v1.6 *
+// SSD1306/SH1106 I2C OLED Graphics Functions                                 * v2.0 *
 // ===================================================================================
 //
 // Functions available:
@@ -10,8 +10,11 @@
 // OLED_invert(v)                 Invert display (0: inverse off, 1: inverse on)
 // OLED_flip(xflip,yflip)         Flip display (0: flip off, 1: flip on)
 // OLED_vscroll(y)                Scroll display vertically
-// OLED_refresh()                 Refresh (flush) screen buffer (send buffer via I2C)
+// OLED_refresh()                 Refresh (flush) screen buffer (send changed parts via I2C)
 // OLED_flush()                   Refresh (flush) screen buffer (alias)
+// OLED_invalidate()              Mark whole screen as changed (next refresh sends everything)
+// OLED_busy()                    Check if OLED refresh is still in progress
+// OLED_render(draw)              Render screen page by page with draw callback (band mode)
 //
 // OLED_clear()                   Clear OLED screen buffer
 // OLED_copy()                    Copy OLED screen buffer (for double-buffer mode)
@@ -55,8 +58,28 @@
 // Notes:
 // ------
 // - color: 0: clear pixel (black), 1: set pixel (white), 2: invert pixel
+// - The drawing functions keep track of the changed columns of each page, only these
+//   are sent by OLED_refresh(). Call OLED_invalidate() after writing to OLED_buffer
+//   directly. In double-buffer mode start each frame with OLED_copy() or OLED_clear(),
+//   otherwise the changed areas of consecutive frames add up.
+// - If the I2C library supports asynchronous transactions (I2C_transferCmd(), e.g.
+//   CH32V003 i2c_dma.h), OLED_refresh() only starts the transfer and returns. Page
+//   addresses and data are then sent one after another from the I2C interrupts. In
+//   double-buffer mode the next frame can be drawn right away, otherwise wait until
+//   OLED_busy() returns 0 before changing the buffer.
+//   The asynchronous refresh uses the I2C on its own and must not share the bus
+//   with the i2c_bus scheduler; submit the buffer as a chunked BUS job instead. If
+//   the I2C is busy with another transaction, the refresh is aborted and everything
+//   is sent with the next OLED_refresh().
 // - size:  1: normal 6x8 pixels, 2: double size (12x16), ... , 8: 8 times (48x64)
 //          9: smoothed double size (12x16), 10: v-stretched (6x16)
+// - Band mode (OLED_BANDED = 1): OLED_buffer holds only one 8-pixel page (OLED_WIDTH
+//   bytes). OLED_render(draw) clears it, calls draw() and sends the page, once for
+//   each page of the screen. All drawing functions clip to the current page, so draw()
+//   simply draws the whole screen every time. It must produce the same picture on each
+//   call (e.g. set the text cursor inside draw()). OLED_band holds the current page
+//   and can be used to skip objects outside of it. OLED_refresh() is not available.
+//   With OLED_DOUBLEBUF the next page is rendered while the previous one is sent.
 //
 // Tested devices:
 // ---------------
@@ -97,6 +120,7 @@ extern "C" {
 #define OLED_INVERT       0         // 1: invert screen with OLED_init()
 #define OLED_PORTRAIT     0         // 1: use OLED in portrait mode
 #define OLED_DOUBLEBUF    0         // 1: use double buffer
+#define OLED_BANDED       0         // 1: page-band rendering with OLED_render() (saves RAM)
 
 // OLED Text Settings
 #define OLED_PRINT        0         // 1: include print functions (needs print.h)
@@ -140,6 +164,13 @@ extern "C" {
 
 #define OLED_abs(n)       (((n)>=0)?(n):(-(n))) // returns positive value of n
 
+// Asynchronous refresh if supported by the I2C library
+#if defined(I2C_transferBusy) && OLED_BANDED == 0
+  #define OLED_ASYNC      1
+#else
+  #define OLED_ASYNC      0
+#endif
+
 // OLED Screen Buffer
 extern uint8_t OLED_buffer[];
 
@@ -148,6 +179,15 @@ extern uint8_t* OLED_drawbuffer;
 extern uint8_t* OLED_sendbuffer;
 #endif
 
+#if OLED_BANDED == 0
+// Changed column range of each page (first > last: page unchanged)
+extern uint8_t OLED_dirty_first[];
+extern uint8_t OLED_dirty_last[];
+#else
+// Page currently rendered by OLED_render()
+extern uint8_t OLED_band;
+#endif
+
 // OLED Control Functions
 void OLED_init(void);
 void OLED_display(uint8_t val);
@@ -156,7 +196,12 @@ void OLED_invert(uint8_t val);
 void OLED_flip(uint8_t xflip, uint8_t yflip);
 void OLED_vscroll(uint8_t y);
 void OLED_home(uint8_t x, uint8_t y);
+void OLED_invalidate(void);
+#if OLED_BANDED == 0
 void OLED_refresh(void);
+#else
+void OLED_render(void (*draw)(void));
+#endif
 
 // OLED Graphics Functions
 void OLED_clear(void);
@@ -183,9 +228,20 @@ void OLED_write(char c);
 void OLED_print(char* str);
 void OLED_printSegment(uint16_t value, uint8_t digits, uint8_t lead, uint8_t decimal);
 
+#if OLED_BANDED == 0
 #define OLED_flush            OLED_refresh
+#endif
 #define OLED_textcolor(c)     OLED_textinvert(!(c))
 
+#if OLED_ASYNC > 0
+extern volatile uint8_t OLED_sending;
+#define OLED_busy()           (OLED_sending)
+#elif defined(I2C_busy)
+#define OLED_busy()           (I2C_busy())
+#else
+#define OLED_busy()           (0)
+#endif
+
 // Additional print functions (if activated, see above)
 #if OLED_PRINT == 1
 #include "print.h"
@@ -1,10 +1,31 @@
 // ===================================================================================
-// ST7302 250x122 Pixels Monochrome Low-Power LCD Graphics Functions          * v1.1 *
+// ST7302 250x122 Pixels Monochrome Low-Power LCD Graphics Functions          * v1.3 *
 // ===================================================================================
 // 2024 by Stefan Wagner:   https://github.com/wagiminator
 
 #include "st7302_gfx_soft.h"
 
+// ===================================================================================
+// Screen Buffer
+// ===================================================================================
+#if LCD_FRAMEBUF > 0
+#define LCD_ROWS          ((LCD_WIDTH + 1) >> 1)    // number of 2-pixel rows
+#define LCD_COLUMNS       ((LCD_HEIGHT + 11) / 12)  // number of 12-pixel columns
+
+// Native 12x2 pixel blocks (3 bytes each), column by column, rows within a column
+uint8_t LCD_buffer[LCD_COLUMNS * LCD_ROWS * 3];
+
+// Changed row range of each column (first > last: column unchanged)
+uint8_t LCD_dirty_first[LCD_COLUMNS];
+uint8_t LCD_dirty_last[LCD_COLUMNS];
+
+// Mark block at row, column as changed
+static inline void LCD_markDirty(uint8_t row, uint8_t column) {
+  if(row < LCD_dirty_first[column]) LCD_dirty_first[column] = row;
+  if(row > LCD_dirty_last[column])  LCD_dirty_last[column]  = row;
+}
+#endif
+
 // ===================================================================================
 // Standard ASCII 5x8 Font (chars 32 - 127)
 // ===================================================================================
@@ -117,31 +138,133 @@ const uint8_t LCD_FONT_SEG[] = {
 #define LCD_sendCommand   LCD_SPI_command
 #define LCD_sendCommand2  LCD_SPI_command2
 
+#if LCD_SPI_HW > 0
+  #if defined(SPI_available)                      // full-duplex SPI library
+    #if LCD_SPI_DMA > 0
+      #define LCD_SPI_send(d) {SPI_DMA_wait(); SPI_transfer(d);}
+    #else
+      #define LCD_SPI_send(d) SPI_transfer(d)
+    #endif
+  #else                                           // TX-only SPI library
+    #define LCD_SPI_send(d)   SPI_write(d)
+  #endif
+
+// Setup hardware SPI (SCL idle high, data sampled on rising edge)
+static void LCD_SPI_setup(void) {
+  SPI_init();
+  SPI_setCPOL(1);
+  SPI_setCPHA(1);
+}
+#endif
+
 // SPI init function (setup pins)
 void LCD_SPI_init(void) {
   PIN_high(LCD_PIN_CS);                           // setup control pins
   PIN_high(LCD_PIN_DC);
-  PIN_high(LCD_PIN_SCL);
   PIN_output(LCD_PIN_CS);
   PIN_output(LCD_PIN_DC);
+  #if LCD_SPI_HW > 0
+  LCD_SPI_setup();
+  #else
+  PIN_high(LCD_PIN_SCL);
   PIN_output(LCD_PIN_SCL);
   PIN_output(LCD_PIN_SDA);
+  #endif
+}
+
+// Wait until all data is shifted out (before changing DC or CS)
+static inline void LCD_SPI_wait(void) {
+  #if LCD_SPI_HW > 0
+  #if LCD_SPI_DMA > 0
+  SPI_DMA_wait();                                 // finish pending DMA transfer
+  #endif
+  while(SPI_busy());
+  #endif
 }
 
 // Transmit one data byte
 void LCD_SPI_write(uint8_t data) {
+  #if LCD_SPI_HW > 0
+  LCD_SPI_send(data);
+  #else
   for(uint8_t i=8; i; i--, data <<= 1) {          // shift out 8 bits, MSB first
     PIN_low(LCD_PIN_SCL);                         // SCL low -> prepare next bit
     if(data & 0x80) PIN_high(LCD_PIN_SDA);        // set SDA according to data bit
     else            PIN_low(LCD_PIN_SDA);
     PIN_high(LCD_PIN_SCL);                        // SCL high -> shift bit out
   }
+  #endif
+}
+
+// Transmit data byte (n) times
+void LCD_SPI_fill(uint8_t data, uint32_t n) {
+  #if LCD_SPI_DMA > 0
+  for(; n > 0xFFFF; n -= 0xFFFF) SPI_fill(data, 0xFFFF);
+  if(n) SPI_fill(data, n);
+  #elif LCD_SPI_HW > 0
+  while(n--) LCD_SPI_send(data);
+  #else
+  if((data == 0x00) || (data == 0xFF)) {          // all bits equal?
+    if(data) PIN_high(LCD_PIN_SDA);               // -> set SDA once
+    else     PIN_low(LCD_PIN_SDA);
+    for(n <<= 3; n; n--) {                        // -> just clock
+      PIN_low(LCD_PIN_SCL);
+      PIN_high(LCD_PIN_SCL);
+    }
+  }
+  else while(n--) LCD_SPI_write(data);
+  #endif
+}
+
+// Transmit buffer (*buf) with (len) bytes
+void LCD_SPI_writeBuffer(const uint8_t* buf, uint16_t len) {
+  #if LCD_SPI_DMA > 0
+  if(len) SPI_writeBuffer(buf, len);
+  #else
+  while(len--) LCD_SPI_write(*buf++);
+  #endif
+}
+
+// Receive (bits) bits after read command and end transmission (CS high)
+// (half-duplex readback is always done by bit-banging SCL and SDA)
+uint32_t LCD_SPI_read(uint8_t bits) {
+  uint32_t data = 0;
+  #if LCD_SPI_HW > 0
+  LCD_SPI_wait();
+  PIN_high(LCD_PIN_SCL);                          // take over SCL from SPI
+  PIN_output(LCD_PIN_SCL);
+  #endif
+  PIN_input_PU(LCD_PIN_SDA);                      // data in
+  for(; bits; bits--) {                           // shift in bits, MSB first
+    PIN_low(LCD_PIN_SCL);                         // SCL low -> shift bit in
+    data <<= 1;                                   // shift data
+    PIN_high(LCD_PIN_SCL);                        // SCL high -> prepare next bit
+    if(PIN_read(LCD_PIN_SDA)) data |= 1;          // set data bit according to SDA
+  }
+  PIN_high(LCD_PIN_CS);                           // end read
+  #if LCD_SPI_HW > 0
+  LCD_SPI_setup();                                // pins back to SPI (CS is high)
+  #else
+  PIN_output(LCD_PIN_SDA);                        // back to data out
+  #endif
+  #if LCD_CS_CONTROL == 0
+  PIN_low(LCD_PIN_CS);
+  #endif
+  return data;
+}
+
+// Wait for transmission to be completed and release CS line
+void LCD_SPI_release(void) {
+  LCD_SPI_wait();
+  PIN_high(LCD_PIN_CS);
 }
 
 // Send a command to the display
 void LCD_SPI_command(uint8_t cmd) {
+  LCD_SPI_wait();
   PIN_low(LCD_PIN_DC);
-  LCD_SPI_write(cmd);
+  LCD_sendData(cmd);
+  LCD_SPI_wait();
   PIN_high(LCD_PIN_DC);
 }
 
@@ -199,7 +322,7 @@ void LCD_init(void) {
   LCD_sendCommand(0x39);                          // Low Power Mode ON
   DLY_ms(100);
   #if LCD_CS_CONTROL > 0
-  PIN_high(LCD_PIN_CS);
+  LCD_SPI_release();
   #endif
 }
 
@@ -210,7 +333,7 @@ void LCD_invert(uint8_t yes) {
   #endif
   LCD_sendCommand(LCD_INVOFF + yes);
   #if LCD_CS_CONTROL > 0
-  PIN_high(LCD_PIN_CS);
+  LCD_SPI_release();
   #endif
 }
 
@@ -222,7 +345,7 @@ void LCD_sleep(uint8_t yes) {
   LCD_sendCommand(LCD_SLPOUT - yes);
   DLY_ms(LCD_SLPOUT_TIME);
   #if LCD_CS_CONTROL > 0
-  PIN_high(LCD_PIN_CS);
+  LCD_SPI_release();
   #endif
 }
 
@@ -236,7 +359,7 @@ void LCD_writeBlock(uint8_t row, uint8_t column, uint32_t block) {
   LCD_sendCommand(LCD_RAMWR);
   LCD_sendData(block >> 16); LCD_sendData(block >> 8); LCD_sendData(block);
   #if LCD_CS_CONTROL > 0
-  PIN_high(LCD_PIN_CS);
+  LCD_SPI_release();
   #endif
 }
 
@@ -248,26 +371,25 @@ uint32_t LCD_readBlock(uint8_t row, uint8_t column) {
   LCD_sendCommand2(LCD_CASET, LCD_YOFF + column, LCD_YOFF + column);
   LCD_sendCommand2(LCD_RASET, LCD_XOFF + row, LCD_XOFF + row);
   LCD_sendCommand(LCD_RAMRD);
-  uint32_t block = 0;
-  PIN_input_PU(LCD_PIN_SDA);                      // data in
-  for(uint8_t i=25; i; i--) {                     // shift in dummy bit + 24 bits, MSB first
-    PIN_low(LCD_PIN_SCL);                         // SCL low -> shift bit in
-    block <<= 1;                                  // shift data byte
-    PIN_high(LCD_PIN_SCL);                        // SCL high -> prepare next bit
-    if(PIN_read(LCD_PIN_SDA)) block |= 1;         // set data bit according to SDA
-  }
-  PIN_output(LCD_PIN_SDA);                        // back to data out
-  PIN_high(LCD_PIN_CS);
-  #if LCD_CS_CONTROL == 0
-  PIN_low(LCD_PIN_CS);
-  #endif
-  return block;
+  return LCD_readData(25);                        // dummy bit + 24 bits, ends with CS high
 }
 
 // ===================================================================================
 // LCD Graphics Functions
 // ===================================================================================
 
+#if LCD_FRAMEBUF > 0
+// Clear screen buffer
+void LCD_clear(void) {
+  uint8_t* ptr = LCD_buffer;
+  for(uint16_t i=sizeof(LCD_buffer); i; i--) *ptr++ = 0;
+  for(uint8_t c=0; c<LCD_COLUMNS; c++) {          // whole screen changed
+    LCD_dirty_first[c] = 0;
+    LCD_dirty_last[c]  = LCD_ROWS - 1;
+  }
+}
+
+#else
 // Global Variables
 uint8_t row0 = 255 >> 1, column0 = 0;
 uint32_t block;
@@ -280,16 +402,13 @@ void LCD_clear(void) {
   LCD_sendCommand2(LCD_CASET, LCD_YOFF, LCD_YOFF + ((LCD_HEIGHT - 1) / 12));  // Column Address Set
   LCD_sendCommand2(LCD_RASET, LCD_XOFF, LCD_XOFF + ((LCD_WIDTH - 1) >> 1));   // Row Address Set
   LCD_sendCommand(LCD_RAMWR);                     // Write to RAM
-  PIN_low(LCD_PIN_SDA);
-  for(uint16_t i=LCD_WIDTH*((LCD_HEIGHT + 11) / 12 * 12); i; i--) {
-    PIN_low(LCD_PIN_SCL);
-    PIN_high(LCD_PIN_SCL);
-  }
+  LCD_SPI_fill(0, LCD_WIDTH * ((LCD_HEIGHT + 11) / 12 * 12) / 8);
   #if LCD_CS_CONTROL > 0
-  PIN_high(LCD_PIN_CS);
+  LCD_SPI_release();
   #endif
   row0 = 255 >> 1; column0 = 0;
 }
+#endif
 
 // Set pixel at position (x,y) with color (0: clear pixel, 1: set pixel, 2: invert pixel)
 void LCD_setPixel(int16_t x, int16_t y, uint8_t color) {
@@ -312,6 +431,16 @@ void LCD_setPixel(int16_t x, int16_t y, uint8_t color) {
     uint8_t bit = ((~y) & 1) | (11 - x % 12) << 1;
   #endif
 
+  #if LCD_FRAMEBUF > 0
+  uint8_t* ptr  = LCD_buffer + ((uint16_t)column * LCD_ROWS + row) * 3 + 2 - (bit >> 3);
+  uint8_t  mask = (uint8_t)1 << (bit & 7);
+  LCD_markDirty(row, column);
+  switch(color) {
+    case 0: *ptr &= ~mask; break;
+    case 1: *ptr |=  mask; break;
+    case 2: *ptr ^=  mask; break;
+  }
+  #else
   if(row != row0 || column != column0) {
     LCD_writeBlock(row0, column0, block);
     block = LCD_readBlock(row, column);
@@ -323,13 +452,38 @@ void LCD_setPixel(int16_t x, int16_t y, uint8_t color) {
     case 1: block |=  ((uint32_t)1 << bit); break;
     case 2: block ^=  ((uint32_t)1 << bit); break;
   }
+  #endif
+}
+
+#if LCD_FRAMEBUF > 0
+// Flush screen buffer (stream changed blocks column by column)
+void LCD_flush(void) {
+  #if LCD_CS_CONTROL > 0
+  PIN_low(LCD_PIN_CS);
+  #endif
+  for(uint8_t c=0; c<LCD_COLUMNS; c++) {
+    uint8_t r0 = LCD_dirty_first[c];
+    uint8_t r1 = LCD_dirty_last[c];
+    if(r0 > r1) continue;                         // column unchanged
+    LCD_sendCommand2(LCD_CASET, LCD_YOFF + c,  LCD_YOFF + c);
+    LCD_sendCommand2(LCD_RASET, LCD_XOFF + r0, LCD_XOFF + r1);
+    LCD_sendCommand(LCD_RAMWR);
+    LCD_SPI_writeBuffer(LCD_buffer + ((uint16_t)c * LCD_ROWS + r0) * 3, (uint16_t)(r1 - r0 + 1) * 3);
+    LCD_dirty_first[c] = 0xFF;                    // column is clean now
+    LCD_dirty_last[c]  = 0;
+  }
+  #if LCD_CS_CONTROL > 0
+  LCD_SPI_release();
+  #endif
 }
 
+#else
 // Flush screen buffer
 void LCD_flush(void) {
   LCD_writeBlock(row0, column0, block);
   row0 = 255 >> 1; column0 = 0;
 }
+#endif
 
 // Get pixel color at (x,y) (0: pixel cleared, 1: pixel set)
 uint8_t LCD_getPixel(int16_t x, int16_t y) {
@@ -351,7 +505,11 @@ uint8_t LCD_getPixel(int16_t x, int16_t y) {
     uint8_t row = y >> 1, column = x / 12;
     uint8_t bit = ((~y) & 1) | (11 - x % 12) << 1;
   #endif
+  #if LCD_FRAMEBUF > 0
+  return((LCD_buffer[((uint16_t)column * LCD_ROWS + row) * 3 + 2 - (bit >> 3)] >> (bit & 7)) & 1);
+  #else
   return((LCD_readBlock(row, column) >> bit) & 1);
+  #endif
 }
 
 // Draw vertical line starting from (x,y), height (h), color (0: cleared, 1: set)
@@ -1,5 +1,5 @@
 // ===================================================================================
-// ST7302 250x122 Pixels Monochrome Low-Power LCD Graphics Functions          * v1.1 *
+// ST7302 250x122 Pixels Monochrome Low-Power LCD Graphics Functions          * v1.3 *
 // ===================================================================================
 //
 // Functions available:
@@ -49,6 +49,18 @@
 // Notes:
 // ------
 // - This library utilizes the integrated software-SPI and works without a screen buffer.
+//   Every block change then costs a read and a write of a 12x2 pixel block.
+// - With LCD_FRAMEBUF = 1 all drawing goes to a RAM framebuffer (about 4 KB, e.g. for
+//   CH32V203 or CH32X035) in the controller's native 12x2 block order. The changed
+//   rows of each 12-pixel column are tracked, LCD_flush() streams them to the LCD.
+//   Compared to the unbuffered mode this saves about 8x bus clocks in landscape and
+//   20x in portrait orientation (simulated mixed drawing). A full redraw is bound by
+//   the pixel data itself, the address commands per column add less than 2%.
+// - With LCD_SPI_HW = 1 the hardware SPI library is used instead (e.g. spi_tx.h, SCL and
+//   SDA must then be the SCK and MOSI pins). If the SPI library provides DMA transfers
+//   (SPI_DMA = 1), LCD_clear() and LCD_flush() send the data via DMA. Reading blocks
+//   back (without framebuffer) still bit-bangs SCL and SDA, the pins are handed back
+//   to SPI after.
 // - color: 0: clear pixel (black), 1: set pixel (white), 2: invert pixel
 // - size:  1: normal 6x8 pixels, 2: double size (12x16), ... , 8: 8 times (48x64)
 //          9: smoothed double size (12x16), 10: v-stretched (6x16)
@@ -86,8 +98,10 @@ extern "C" {
 #define LCD_SLPOUT_TIME   100       // time to wait after sleep out in milliseconds
 
 #define LCD_CS_CONTROL    0         // 1: active control of CS-line
+#define LCD_SPI_HW        0         // 1: use hardware SPI library (see below)
 #define LCD_FLIP          0         // 1: flip LCD screen
 #define LCD_PORTRAIT      0         // 1: use LCD in portrait mode
+#define LCD_FRAMEBUF      0         // 1: use RAM framebuffer (needs about 4 KB RAM)
 
 // LCD Text Settings
 #define LCD_PRINT         0         // 1: include print functions (needs print.h)
@@ -96,6 +110,18 @@ extern "C" {
 #define LCD_SMOOTH        9         // character size value for double-size smoothed
 #define LCD_STRETCH       10        // character size value for v-stretched
 
+// Hardware SPI library and DMA (if activated)
+#if LCD_SPI_HW > 0
+  #include "spi_tx.h"               // choose your SPI library (spi_tx.h or spi.h)
+  #if defined(SPI_DMA) && SPI_DMA > 0
+    #define LCD_SPI_DMA   1
+  #else
+    #define LCD_SPI_DMA   0
+  #endif
+#else
+  #define LCD_SPI_DMA     0
+#endif
+
 // LCD Commands
 #define LCD_RESET         0x01      // Software Reset
 #define LCD_SLPIN         0x10      // Sleep IN
@@ -112,6 +138,11 @@ extern "C" {
 
 #define LCD_abs(n)        (((n)>=0)?(n):(-(n))) // returns positive value of n
 
+// LCD Screen Buffer
+#if LCD_FRAMEBUF > 0
+extern uint8_t LCD_buffer[];
+#endif
+
 // LCD Control Functions
 void LCD_init(void);
 void LCD_invert(uint8_t yes);
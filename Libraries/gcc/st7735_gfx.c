@@ -1,5 +1,5 @@
 // ===================================================================================
-// ST7735/ST7789/ILI9340/ILI9341 Color TFT Graphics Functions                 * v1.4 *
+// ST7735/ST7789/ILI9340/ILI9341 Color TFT Graphics Functions                 * v1.5 *
 // ===================================================================================
 // 2024 by Stefan Wagner:   https://github.com/wagiminator
 
@@ -131,7 +131,11 @@ void TFT_SPI_init(void) {
 
 // Send a command to the display
 void TFT_SPI_command(uint8_t cmd) {
+  #if TFT_DMA > 0
+  SPI_DMA_wait();                                 // finish pending DMA transfer
+  #else
   while(SPI_busy());
+  #endif
   PIN_low(TFT_PIN_DC);
   TFT_sendData(cmd);
   while(SPI_busy());
@@ -152,6 +156,28 @@ void TFT_resync(void) {
   #endif
 }
 
+#if TFT_DMA > 0
+// Wait for DMA transfer to be completed and release CS line
+void TFT_wait(void) {
+  SPI_DMA_wait();
+  #if TFT_CS_CONTROL > 0
+  PIN_high(TFT_PIN_CS);
+  #endif
+}
+
+// Send color (n) times via DMA (16-bit frames)
+void TFT_DMA_fill(uint16_t color, uint32_t n) {
+  for(; n > 0xFFFF; n -= 0xFFFF) SPI_fill16(color, 0xFFFF);
+  SPI_fill16(color, n);
+}
+
+// Send 16-bit color buffer with (n) pixels via DMA
+void TFT_DMA_write(const uint16_t* buf, uint32_t n) {
+  for(; n > 0xFFFF; n -= 0xFFFF, buf += 0xFFFF) SPI_writeBuffer16(buf, 0xFFFF);
+  SPI_writeBuffer16(buf, n);
+}
+#endif
+
 // ===================================================================================
 // TFT Control Functions
 // ===================================================================================
@@ -217,8 +243,11 @@ void TFT_invert(uint8_t yes) {
   #endif
 }
 
-// Start sending data stream to RAM
-void TFT_streamStart(int16_t x, int16_t y, int16_t w, int16_t h) {
+// Current color mode of the TFT
+uint8_t TFT_colorbits = TFT_COLORBITS;
+
+// Start sending data stream with color mode (12 or 16 bits) to RAM
+void TFT_streamStart(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t bits) {
   int16_t row1 = TFT_XOFF + x;
   int16_t row2 = row1 + w - 1;
   int16_t col1 = TFT_YOFF + y;
@@ -226,6 +255,11 @@ void TFT_streamStart(int16_t x, int16_t y, int16_t w, int16_t h) {
   #if TFT_CS_CONTROL > 0
     PIN_low(TFT_PIN_CS);
   #endif
+  if(bits != TFT_colorbits) {                     // switch color mode if necessary
+    TFT_sendCommand(TFT_COLMOD);
+    TFT_sendData(bits == 16 ? 0x05 : 0x03);
+    TFT_colorbits = bits;
+  }
   TFT_sendCommand2(TFT_CASET, col1, col2);        // column address set
   TFT_sendCommand2(TFT_RASET, row1, row2);        // row address set
   TFT_sendCommand(TFT_RAMWR);                     // write to RAM
@@ -234,6 +268,9 @@ void TFT_streamStart(int16_t x, int16_t y, int16_t w, int16_t h) {
 // Stop sending data stream to RAM
 void TFT_streamStop(void) {
   #if TFT_CS_CONTROL > 0
+    #if TFT_DMA > 0
+    if(SPI_DMA_busy()) return;                    // CS is released after DMA transfer
+    #endif
     while(SPI_busy());
     PIN_high(TFT_PIN_CS);
   #endif
@@ -262,20 +299,15 @@ void TFT_streamColor(uint16_t color) {
 // TFT Graphics Functions
 // ===================================================================================
 
-// Clear screen
+// Clear screen (in 12-bit color mode)
 void TFT_clear(void) {
-  #if TFT_COLORBITS == 16
-    #if TFT_CS_CONTROL > 0
-      PIN_low(TFT_PIN_CS);
-    #endif
-    TFT_sendCommand(TFT_COLMOD); TFT_sendData(0x03);      // switch to 12-bit color
-  #endif
-
-  TFT_streamStart(0, 0, TFT_WIDTH, TFT_HEIGHT);
-  for(uint32_t i=TFT_WIDTH*TFT_HEIGHT*12/8; i; i--) TFT_sendData(0);
-
-  #if TFT_COLORBITS == 16
-    TFT_sendCommand(TFT_COLMOD); TFT_sendData(0x05);      // switch back to 16-bit color
+  TFT_streamStart(0, 0, TFT_WIDTH, TFT_HEIGHT, 12);
+  #if TFT_DMA > 0
+    uint32_t i = (uint32_t)TFT_WIDTH*TFT_HEIGHT*12/8;
+    for(; i > 0xFFFF; i -= 0xFFFF) SPI_fill(0, 0xFFFF);
+    SPI_fill(0, i);
+  #else
+    for(uint32_t i=TFT_WIDTH*TFT_HEIGHT*12/8; i; i--) TFT_sendData(0);
   #endif
   TFT_streamStop();
 }
@@ -283,7 +315,7 @@ void TFT_clear(void) {
 // Set pixel at position (x,y) with color
 void TFT_setPixel(int16_t x, int16_t y, uint16_t color) {
   if((x < 0) || (x >= TFT_WIDTH) || (y < 0) || (y >= TFT_HEIGHT)) return;
-  TFT_streamStart(x, y, 1, 1);
+  TFT_streamStart(x, y, 1, 1, TFT_COLORBITS);
   TFT_sendData(color >> 8); TFT_sendData(color);  // write pixel color
   TFT_streamStop();
 }
@@ -301,12 +333,16 @@ void TFT_fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
   w = x1 - x;
   h = y1 - y;
 
-  TFT_streamStart(x, y, w, h);
-  #if TFT_COLORBITS == 16
+  #if TFT_DMA > 0
+    TFT_streamStart(x, y, w, h, 16);              // DMA fills use 16-bit frames
+    TFT_DMA_fill(color, (uint32_t)w * h);
+  #elif TFT_COLORBITS == 16
+    TFT_streamStart(x, y, w, h, 16);
     for(uint32_t i=w*h; i; i--) {
       TFT_sendData(color >> 8); TFT_sendData(color);
     }
   #else
+    TFT_streamStart(x, y, w, h, 12);
     uint8_t c1 = color >> 8, c2 = (color & 0xf0) | (color >> 12), c3 = color >> 4;
     for(uint32_t i=((w*h)+1)>>1; i; i--) {
       TFT_sendData(c1); TFT_sendData(c2); TFT_sendData(c3);
@@ -426,21 +462,14 @@ void TFT_fillCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color) {
 
 // Draw bitmap at position (x0,y0), width (w), hight (h), pointer to bitmap (*bmp)
 void TFT_drawBitmap(int16_t x0, int16_t y0, int16_t w, int16_t h, const uint16_t* bmp) {
-  #if TFT_COLORBITS == 12
-    #if TFT_CS_CONTROL > 0
-      PIN_low(TFT_PIN_CS);
-    #endif
-    TFT_sendCommand(TFT_COLMOD); TFT_sendData(0x05);    // switch to 16-bit color
-  #endif
-
-  TFT_streamStart(x0, y0, w, h);
-  for(uint32_t i=w*h; i; i--) {
-    uint16_t color = *bmp++;
-    TFT_sendData(color >> 8); TFT_sendData(color);
-  }
-
-  #if TFT_COLORBITS == 12
-    TFT_sendCommand(TFT_COLMOD); TFT_sendData(0x03);    // switch back to 12-bit color
+  TFT_streamStart(x0, y0, w, h, 16);              // bitmaps use 16-bit color
+  #if TFT_DMA > 0
+    TFT_DMA_write(bmp, (uint32_t)w * h);
+  #else
+    for(uint32_t i=w*h; i; i--) {
+      uint16_t color = *bmp++;
+      TFT_sendData(color >> 8); TFT_sendData(color);
+    }
   #endif
   TFT_streamStop();
 }
@@ -497,7 +526,7 @@ uint16_t TFT_stretch(uint16_t x) {
 
 // Print a bitmap at cursor position with foreground and background color
 void TFT_printBitmap(uint16_t w, uint16_t h, const uint8_t* bmp) {
-  TFT_streamStart(TFT_cx, TFT_cy, w, h);
+  TFT_streamStart(TFT_cx, TFT_cy, w, h, TFT_COLORBITS);
   for(uint8_t x=w; x; x--) {
     for(uint8_t y=h>>3; y; y--) {
       uint8_t line = *bmp++;
@@ -522,7 +551,7 @@ void TFT_write(char c) {
       uint8_t w = (TFT_cs << 2) + (TFT_cs << 1);
       uint8_t h = (TFT_cs << 3);
 
-      TFT_streamStart(TFT_cx, TFT_cy, w, h);
+      TFT_streamStart(TFT_cx, TFT_cy, w, h, TFT_COLORBITS);
       for(uint8_t x=6; x; x--) {
         uint8_t line = 0;
         if(x > 1) line = TFT_FONT[ptr++];
@@ -1,5 +1,5 @@
 // ===================================================================================
-// ST7735/ST7789/ILI9340/ILI9341 Color TFT Graphics Functions                 * v1.4 *
+// ST7735/ST7789/ILI9340/ILI9341 Color TFT Graphics Functions                 * v1.5 *
 // ===================================================================================
 //
 // Functions available:
@@ -9,6 +9,8 @@
 // TFT_sleep(v)                   Set display sleep mode (0: sleep off, 1: sleep on)
 // TFT_invert(v)                  Invert display (0: inverse off, 1: inverse on)
 // TFT_resync()                   Resync by toggling CS pin (for non-active control of CS-line mode)
+// TFT_busy()                     Check if a DMA transfer to the TFT is in progress
+// TFT_wait()                     Wait for DMA transfer to be completed and release CS-line
 //
 // TFT_clear()                    Clear TFT screen
 // TFT_fill(c)                    Fill screen with color (c)
@@ -76,6 +78,10 @@
 // ------
 // - Define TFT parameters down below!
 // - This library works without a screen buffer.
+// - If the SPI library provides DMA transfers (SPI_DMA = 1), TFT_clear(), TFT_fill(),
+//   TFT_fillRect() and TFT_drawBitmap() return before the transfer is completed. The
+//   next TFT function waits for it. Use TFT_wait() before accessing other devices on
+//   the SPI bus or changing the bitmap.
 // - color: 16-bit color mode (5 bits red, 6 bits green, 5 bits blue) or
 //          12-bit color mode (4 bits red, 4 bits green, 4 bits blue)
 // - size:  1: normal 6x8 pixels, 2: double size (12x16), ... , 8: 8 times (48x64)
@@ -97,6 +103,13 @@ extern "C" {
 #include "gpio.h"
 #include "spi_tx.h"                 // choose your SPI library
 
+// Use DMA, if provided by SPI library
+#if defined(SPI_DMA) && SPI_DMA > 0
+  #define TFT_DMA         1
+#else
+  #define TFT_DMA         0
+#endif
+
 // TFT Pins
 #define TFT_PIN_DC        PC3       // pin connected to DC (data/command) of TFT
 #define TFT_PIN_CS        PC4       // pin connected to CS (select) of TFT
@@ -159,6 +172,14 @@ void TFT_sleep(uint8_t yes);
 void TFT_invert(uint8_t yes);
 void TFT_resync(void);
 
+#if TFT_DMA > 0
+#define TFT_busy()        SPI_DMA_busy()
+void TFT_wait(void);
+#else
+#define TFT_busy()        0
+#define TFT_wait()
+#endif
+
 // TFT Graphics Functions
 void TFT_clear(void);
 void TFT_fill(uint16_t color);
@@ -1,7 +1,7 @@
 // ===================================================================================
-// ST7735/ST7789/ILI9340/ILI9341 Color TFT Graphics Functions                 * v1.2 *
+// ST7735/ST7789/ILI9340/ILI9341 Color TFT Graphics Functions                 * v1.3 *
 // ===================================================================================
-// with software-SPI
+// with software-SPI or hardware-SPI
 // 2024 by Stefan Wagner:   https://github.com/wagiminator
 
 #include "st7735_gfx_soft.h"
@@ -115,34 +115,143 @@ const uint8_t TFT_FONT_SEG2[] = {
 // ===================================================================================
 #define TFT_sendData      TFT_SPI_write
 #define TFT_readData      TFT_SPI_read
+#define TFT_SPI_BUFLEN    96        // DMA pattern buffer length (multiple of 6)
 #define TFT_sendCommand   TFT_SPI_command
 #define TFT_sendCommand2  TFT_SPI_command2
 
+#if TFT_SPI_HW > 0
+  #if defined(SPI_available)                      // full-duplex SPI library
+    #if TFT_SPI_DMA > 0
+      #define TFT_SPI_send(d) {SPI_DMA_wait(); SPI_transfer(d);}
+    #else
+      #define TFT_SPI_send(d) SPI_transfer(d)
+    #endif
+  #else                                           // TX-only SPI library
+    #define TFT_SPI_send(d)   SPI_write(d)
+  #endif
+
+// Setup hardware SPI (SCL idle high, data sampled on rising edge)
+static void TFT_SPI_setup(void) {
+  SPI_init();
+  SPI_setCPOL(1);
+  SPI_setCPHA(1);
+}
+#endif
+
 // SPI init function (setup pins)
 void TFT_SPI_init(void) {
   PIN_high(TFT_PIN_CS);                           // setup control pins
   PIN_high(TFT_PIN_DC);
-  PIN_high(TFT_PIN_SCL);
   PIN_output(TFT_PIN_CS);
   PIN_output(TFT_PIN_DC);
+  #if TFT_SPI_HW > 0
+  TFT_SPI_setup();
+  #else
+  PIN_high(TFT_PIN_SCL);
   PIN_output(TFT_PIN_SCL);
   PIN_output(TFT_PIN_SDA);
+  #endif
+}
+
+// Wait until all data is shifted out (before changing DC or CS)
+static inline void TFT_SPI_wait(void) {
+  #if TFT_SPI_HW > 0
+  #if TFT_SPI_DMA > 0
+  SPI_DMA_wait();                                 // finish pending DMA transfer
+  #endif
+  while(SPI_busy());
+  #endif
 }
 
 // Transmit one data byte
 void TFT_SPI_write(uint8_t data) {
+  #if TFT_SPI_HW > 0
+  TFT_SPI_send(data);
+  #else
   for(uint8_t i=8; i; i--, data <<= 1) {          // shift out 8 bits, MSB first
     PIN_low(TFT_PIN_SCL);                         // SCL low -> prepare next bit
     if(data & 0x80) PIN_high(TFT_PIN_SDA);        // set SDA according to data bit
     else            PIN_low(TFT_PIN_SDA);
     PIN_high(TFT_PIN_SCL);                        // SCL high -> shift bit out
   }
+  #endif
+}
+
+// Transmit data byte (n) times
+void TFT_SPI_fill(uint8_t data, uint32_t n) {
+  #if TFT_SPI_DMA > 0
+  for(; n > 0xFFFF; n -= 0xFFFF) SPI_fill(data, 0xFFFF);
+  if(n) SPI_fill(data, n);
+  #elif TFT_SPI_HW > 0
+  while(n--) TFT_SPI_send(data);
+  #else
+  if((data == 0x00) || (data == 0xFF)) {          // all bits equal?
+    if(data) PIN_high(TFT_PIN_SDA);               // -> set SDA once
+    else     PIN_low(TFT_PIN_SDA);
+    for(n <<= 3; n; n--) {                        // -> just clock
+      PIN_low(TFT_PIN_SCL);
+      PIN_high(TFT_PIN_SCL);
+    }
+  }
+  else while(n--) TFT_SPI_write(data);
+  #endif
+}
+
+// Transmit pattern (*pat) of (len) bytes (2 or 3) (n) times
+void TFT_SPI_pattern(const uint8_t* pat, uint8_t len, uint32_t n) {
+  #if TFT_SPI_DMA > 0
+  static uint8_t buf[TFT_SPI_BUFLEN];             // repeated pattern as DMA source
+  SPI_DMA_wait();                                 // buffer may still be in use
+  for(uint8_t i=0; i<TFT_SPI_BUFLEN; i++) buf[i] = pat[i % len];
+  for(n *= len; n > TFT_SPI_BUFLEN; n -= TFT_SPI_BUFLEN) SPI_writeBuffer(buf, TFT_SPI_BUFLEN);
+  if(n) SPI_writeBuffer(buf, n);
+  #else
+  while(n--) {
+    for(uint8_t i=0; i<len; i++) TFT_SPI_write(pat[i]);
+  }
+  #endif
+}
+
+// Receive (bits) bits after read command and end transmission (CS high)
+// (half-duplex readback is always done by bit-banging SCL and SDA)
+uint32_t TFT_SPI_read(uint8_t bits) {
+  uint32_t data = 0;
+  #if TFT_SPI_HW > 0
+  TFT_SPI_wait();
+  PIN_high(TFT_PIN_SCL);                          // take over SCL from SPI
+  PIN_output(TFT_PIN_SCL);
+  #endif
+  PIN_input_PU(TFT_PIN_SDA);                      // data in
+  for(; bits; bits--) {                           // shift in bits, MSB first
+    PIN_low(TFT_PIN_SCL);                         // SCL low -> shift bit in
+    data <<= 1;                                   // shift data
+    PIN_high(TFT_PIN_SCL);                        // SCL high -> prepare next bit
+    if(PIN_read(TFT_PIN_SDA)) data |= 1;          // set data bit according to SDA
+  }
+  PIN_high(TFT_PIN_CS);                           // end read
+  #if TFT_SPI_HW > 0
+  TFT_SPI_setup();                                // pins back to SPI (CS is high)
+  #else
+  PIN_output(TFT_PIN_SDA);                        // back to data out
+  #endif
+  #if TFT_CS_CONTROL == 0
+  PIN_low(TFT_PIN_CS);
+  #endif
+  return data;
+}
+
+// Wait for transmission to be completed and release CS line
+void TFT_SPI_release(void) {
+  TFT_SPI_wait();
+  PIN_high(TFT_PIN_CS);
 }
 
 // Send a command to the display
 void TFT_SPI_command(uint8_t cmd) {
+  TFT_SPI_wait();
   PIN_low(TFT_PIN_DC);
   TFT_sendData(cmd);
+  TFT_SPI_wait();
   PIN_high(TFT_PIN_DC);
 }
 
@@ -155,7 +264,7 @@ void TFT_SPI_command2(uint8_t c, uint16_t d1, uint16_t d2) {
 // Resync by toggling CS pin (for non-active control of CS-line mode)
 void TFT_resync(void) {
   #if TFT_CS_CONTROL > 0
-  PIN_high(TFT_PIN_CS);
+  TFT_SPI_release();
   PIN_low(TFT_PIN_CS);
   #endif
 }
@@ -187,7 +296,7 @@ void TFT_init(void) {
   DLY_ms(TFT_SLPOUT_TIME);
   TFT_sendCommand(TFT_DISPON);                    // turn on display
   #if TFT_CS_CONTROL > 0
-  PIN_high(TFT_PIN_CS);
+  TFT_SPI_release();
   #endif
 }
 
@@ -198,7 +307,7 @@ void TFT_power(uint8_t yes) {
   #endif
   TFT_sendCommand(TFT_DISPOFF + yes);
   #if TFT_CS_CONTROL > 0
-  PIN_high(TFT_PIN_CS);
+  TFT_SPI_release();
   #endif
 }
 
@@ -210,7 +319,7 @@ void TFT_sleep(uint8_t yes) {
   TFT_sendCommand(TFT_SLPOUT - yes);
   DLY_ms(TFT_SLPOUT_TIME);
   #if TFT_CS_CONTROL > 0
-  PIN_high(TFT_PIN_CS);
+  TFT_SPI_release();
   #endif
 }
 
@@ -221,7 +330,7 @@ void TFT_invert(uint8_t yes) {
   #endif
   TFT_sendCommand(TFT_INVOFF + yes);
   #if TFT_CS_CONTROL > 0
-  PIN_high(TFT_PIN_CS);
+  TFT_SPI_release();
   #endif
 }
 
@@ -240,16 +349,12 @@ void TFT_clear(void) {
   TFT_sendCommand(0x3A); TFT_sendData(0x03);                        // 12-bit color
   #endif
   TFT_sendCommand(TFT_RAMWR);                                       // write to RAM
-  PIN_low(TFT_PIN_SDA);
-  for(uint32_t i=TFT_WIDTH*TFT_HEIGHT*12; i; i--) {
-    PIN_low(TFT_PIN_SCL);
-    PIN_high(TFT_PIN_SCL);
-  }
+  TFT_SPI_fill(0, ((uint32_t)TFT_WIDTH * TFT_HEIGHT * 3 + 1) >> 1);  // 12 bits per pixel
   #if TFT_COLORBITS == 16
   TFT_sendCommand(0x3A); TFT_sendData(0x05);                        // back to 16-bit color
   #endif
   #if TFT_CS_CONTROL > 0
-    PIN_high(TFT_PIN_CS);
+    TFT_SPI_release();
   #endif
 }
 
@@ -290,7 +395,7 @@ void TFT_setPixel(int16_t x, int16_t y, uint16_t color) {
   TFT_sendCommand(TFT_RAMWR);                     // write to RAM
   TFT_sendData(color >> 8); TFT_sendData(color);  // write pixel color
   #if TFT_CS_CONTROL > 0
-    PIN_high(TFT_PIN_CS);
+    TFT_SPI_release();
   #endif
 }
 
@@ -328,20 +433,8 @@ uint16_t TFT_getPixel(int16_t x, int16_t y) {
   #endif
   TFT_sendCommand2(TFT_CASET, col, col);          // column address set
   TFT_sendCommand2(TFT_RASET, row, row);          // row address set
-  TFT_sendCommand(TFT_RAMRD);                     // write to RAM
-  uint16_t color = 0;
-  PIN_input_PU(TFT_PIN_SDA);                      // data in
-  for(uint8_t i=17; i; i--) {                     // shift in dummy bit + 16 bits, MSB first
-    PIN_low(TFT_PIN_SCL);                         // SCL low -> shift bit in
-    color <<= 1;                                  // shift data byte
-    PIN_high(TFT_PIN_SCL);                        // SCL high -> prepare next bit
-    if(PIN_read(TFT_PIN_SDA)) color |= 1;         // set data bit according to SDA
-  }
-  PIN_output(TFT_PIN_SDA);                        // back to data out
-  #if TFT_CS_CONTROL > 0
-    PIN_high(TFT_PIN_CS);
-  #endif
-  return color;
+  TFT_sendCommand(TFT_RAMRD);                     // read from RAM
+  return TFT_readData(17);                        // dummy bit + 16 bits, ends with CS high
 }
 
 // Draw filled rectangle starting from (x,y), width (w), height (h), color
@@ -394,18 +487,15 @@ void TFT_fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
   TFT_sendCommand(TFT_RAMWR);                     // write to RAM
 
   #if TFT_COLORBITS == 16
-    for(uint32_t i=(col2-col1+1)*(row2-row1+1); i; i--) {
-      TFT_sendData(color >> 8); TFT_sendData(color);
-    }
+    uint8_t pat[2] = {color >> 8, color};
+    TFT_SPI_pattern(pat, 2, (uint32_t)(col2-col1+1)*(row2-row1+1));
   #else
-    uint8_t c1 = color >> 8, c2 = (color & 0xf0) | (color >> 12), c3 = color >> 4;
-    for(uint32_t i=((col2-col1+1)*(row2-row1+1)+1)>>1; i; i--) {
-      TFT_sendData(c1); TFT_sendData(c2); TFT_sendData(c3);
-    }
+    uint8_t pat[3] = {color >> 8, (color & 0xf0) | (color >> 12), color >> 4};
+    TFT_SPI_pattern(pat, 3, ((uint32_t)(col2-col1+1)*(row2-row1+1)+1)>>1);
   #endif
 
   #if TFT_CS_CONTROL > 0
-    PIN_high(TFT_PIN_CS);
+    TFT_SPI_release();
   #endif
 }
 
@@ -1,5 +1,5 @@
 // ===================================================================================
-// ST7735/ST7789/ILI9340/ILI9341 Color TFT Graphics Functions                 * v1.2 *
+// ST7735/ST7789/ILI9340/ILI9341 Color TFT Graphics Functions                 * v1.3 *
 // ===================================================================================
 //
 // Functions available:
@@ -75,6 +75,10 @@
 // ------
 // - Define TFT parameters down below!
 // - This library utilizes the integrated software-SPI and works without a screen buffer.
+// - With TFT_SPI_HW = 1 the hardware SPI library is used instead (e.g. spi_tx.h, SCL and
+//   SDA must then be the SCK and MOSI pins). If the SPI library provides DMA transfers
+//   (SPI_DMA = 1), TFT_clear() and TFT_fillRect() send the data via DMA. Reading pixels
+//   (TFT_getPixel()) still bit-bangs SCL and SDA, the pins are handed back to SPI after.
 // - color: 16-bit color mode (5 bits red, 6 bits green, 5 bits blue) or
 //          12-bit color mode (4 bits red, 4 bits green, 4 bits blue)
 // - size:  1: normal 6x8 pixels, 2: double size (12x16), ... , 8: 8 times (48x64)
@@ -114,6 +118,7 @@ extern "C" {
 
 // TFT SPI and Timing Parameters
 #define TFT_CS_CONTROL    0         // 1: active control of CS-line
+#define TFT_SPI_HW        0         // 1: use hardware SPI library (see below)
 #define TFT_BOOT_TIME     0         // TFT boot up time in milliseconds
 #define TFT_RST_TIME      50        // time to wait after reset in milliseconds
 #define TFT_SLPOUT_TIME   150       // time to wait after sleep out in milliseconds
@@ -131,6 +136,18 @@ extern "C" {
 #define TFT_SMOOTH        9         // character size value for double-size smoothed
 #define TFT_STRETCH       10        // character size value for v-stretched
 
+// Hardware SPI library and DMA (if activated)
+#if TFT_SPI_HW > 0
+  #include "spi_tx.h"               // choose your SPI library (spi_tx.h or spi.h)
+  #if defined(SPI_DMA) && SPI_DMA > 0
+    #define TFT_SPI_DMA   1
+  #else
+    #define TFT_SPI_DMA   0
+  #endif
+#else
+  #define TFT_SPI_DMA     0
+#endif
+
 // TFT Commands
 #define TFT_RESET         0x01      // Software Reset
 #define TFT_SLPIN         0x10      // Sleep IN
@@ -1,5 +1,5 @@
 // ===================================================================================
-// UART1 with DMA RX Buffer for PY32F0xx                                      * v1.0 *
+// UART1 with DMA RX Buffer for PY32F0xx                                      * v1.1 *
 // ===================================================================================
 // 2023 by Stefan Wagner:   https://github.com/wagiminator
 
@@ -125,3 +125,18 @@ void UART_write(const char c) {
   while(!UART_ready());
   USART1->DR = c;
 }
+
+// Get pointer to longest contiguous readable span in RX buffer, return its length
+uint16_t UART_peek(const char** ptr) {
+  uint16_t hptr = UART_RX_hptr;
+  *ptr = UART_RX_buffer + UART_RX_tptr;
+  if(hptr >= UART_RX_tptr) return(hptr - UART_RX_tptr);
+  return(UART_RX_BUF_SIZE - UART_RX_tptr);
+}
+
+// Remove n bytes from RX buffer
+void UART_consume(uint16_t n) {
+  n += UART_RX_tptr;
+  if(n >= UART_RX_BUF_SIZE) n -= UART_RX_BUF_SIZE;
+  UART_RX_tptr = n;
+}
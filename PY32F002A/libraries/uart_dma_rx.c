@@ -1,5 +1,5 @@
 // ===================================================================================
-// UART1 with DMA (RX only) for PY32F0xx                                      * v1.0 *
+// UART1 with DMA (RX only) for PY32F0xx                                      * v1.1 *
 // ===================================================================================
 // 2023 by Stefan Wagner:   https://github.com/wagiminator
 
@@ -129,3 +129,18 @@ char UART_read(void) {
   if(UART_RX_tptr >= UART_RX_BUF_SIZE) UART_RX_tptr = 0;
   return result;
 }
+
+// Get pointer to longest contiguous readable span in RX buffer, return its length
+uint16_t UART_peek(const char** ptr) {
+  uint16_t hptr = UART_RX_hptr;
+  *ptr = UART_RX_buffer + UART_RX_tptr;
+  if(hptr >= UART_RX_tptr) return(hptr - UART_RX_tptr);
+  return(UART_RX_BUF_SIZE - UART_RX_tptr);
+}
+
+// Remove n bytes from RX buffer
+void UART_consume(uint16_t n) {
+  n += UART_RX_tptr;
+  if(n >= UART_RX_BUF_SIZE) n -= UART_RX_BUF_SIZE;
+  UART_RX_tptr = n;
+}
@@ -1,5 +1,5 @@
 // ===================================================================================
-// Basic SPI Master Functions for STM32C0xx                                   * v1.0 *
+// SPI Master Functions with DMA Buffer Transfers for STM32C0xx             * v1.1 *
 // ===================================================================================
 // 2023 by Stefan Wagner:   https://github.com/wagiminator
 
@@ -71,6 +71,20 @@ void SPI_init(void) {
                 | SPI_CR1_SSI         // set internal NSS high
                 | SPI_CR1_SPE;        // enable SPI
   SPI1->CR2     = SPI_CR2_FRXTH;      // set RXNE flag after 8-bit
+
+  #if SPI_DMA > 0
+  // Setup DMA channel 2 (RX) and channel 3 (TX)
+  RCC->AHBENR |= RCC_AHBENR_DMA1EN;               // enable DMA module clock
+  DMAMUX1_Channel1->CCR = 16;                     // set SPI1 RX as trigger
+  DMAMUX1_Channel2->CCR = 17;                     // set SPI1 TX as trigger
+  DMA1_Channel2->CPAR = (uint32_t)&SPI1->DR;      // peripheral address
+  DMA1_Channel2->CCR  = DMA_CCR_PL_1              // high priority (no RX overrun)
+                      | DMA_CCR_TCIE;             // transfer complete interrupt enable
+  DMA1_Channel3->CPAR = (uint32_t)&SPI1->DR;      // peripheral address
+  DMA1_Channel3->CCR  = DMA_CCR_DIR;              // memory to SPI
+  DMA1->IFCR = DMA_IFCR_CGIF2 | DMA_IFCR_CGIF3;   // clear interrupt flags
+  NVIC_EnableIRQ(DMA1_Channel2_3_IRQn);           // enable the DMA IRQ
+  #endif
 }
 
 // Transfer one data byte (read and write)
@@ -79,3 +93,75 @@ uint8_t SPI_transfer(uint8_t data) {
   while(!SPI_available());            // wait for data byte received
   return(SPI_DR_8BIT);                // return received data byte
 }
+
+// ===================================================================================
+// DMA Buffer Transfers
+// ===================================================================================
+#if SPI_DMA > 0
+
+void (*SPI_DMA_callback)(void) = 0;   // function called after DMA transfer
+static uint8_t SPI_DMA_value;         // source of repeated TX byte
+static uint8_t SPI_DMA_dummy;         // sink of discarded RX bytes
+
+// Start DMA transfer; transfer is completed, when the last byte has been received
+static void SPI_DMA_start(const uint8_t* tx, uint8_t* rx, uint16_t len) {
+  SPI_DMA_wait();                                 // wait for previous transfer
+  while(SPI_busy());                              // wait for byte-wise transfers
+  while(SPI_available()) (void)SPI_DR_8BIT;       // discard old received data
+
+  // Setup RX channel
+  if(rx) {
+    DMA1_Channel2->CMAR = (uint32_t)rx;           // receive buffer
+    DMA1_Channel2->CCR |=  DMA_CCR_MINC;          // increment memory address
+  }
+  else {
+    DMA1_Channel2->CMAR = (uint32_t)&SPI_DMA_dummy;
+    DMA1_Channel2->CCR &= ~DMA_CCR_MINC;          // discard received data
+  }
+  DMA1_Channel2->CNDTR = len;
+
+  // Setup TX channel
+  if(tx) {
+    DMA1_Channel3->CMAR = (uint32_t)tx;           // transmit buffer
+    DMA1_Channel3->CCR |=  DMA_CCR_MINC;          // increment memory address
+  }
+  else {
+    DMA1_Channel3->CMAR = (uint32_t)&SPI_DMA_value;
+    DMA1_Channel3->CCR &= ~DMA_CCR_MINC;          // repeat single value
+  }
+  DMA1_Channel3->CNDTR = len;
+
+  // Start transfer (RX first, so no byte gets lost)
+  DMA1_Channel2->CCR |= DMA_CCR_EN;
+  DMA1_Channel3->CCR |= DMA_CCR_EN;
+  SPI1->CR2 |= SPI_CR2_RXDMAEN | SPI_CR2_TXDMAEN;
+}
+
+// Transmit and receive buffers via DMA (tx and/or rx may be NULL)
+void SPI_transferBuffer(const uint8_t* tx, uint8_t* rx, uint16_t len) {
+  if(!len) return;
+  if(!tx) {
+    SPI_DMA_wait();
+    SPI_DMA_value = 0x00;
+  }
+  SPI_DMA_start(tx, rx, len);
+}
+
+// Transmit one data byte repeatedly via DMA
+void SPI_fill(uint8_t data, uint16_t len) {
+  if(!len) return;
+  SPI_DMA_wait();
+  SPI_DMA_value = data;
+  SPI_DMA_start(0, 0, len);
+}
+
+// DMA RX complete: all bytes transmitted and received
+void DMA1_Channel2_3_IRQHandler(void) {
+  SPI1->CR2 &= ~(SPI_CR2_RXDMAEN | SPI_CR2_TXDMAEN);  // disable DMA requests
+  DMA1_Channel3->CCR &= ~DMA_CCR_EN;              // disable DMA channels
+  DMA1_Channel2->CCR &= ~DMA_CCR_EN;
+  DMA1->IFCR = DMA_IFCR_CGIF2 | DMA_IFCR_CGIF3;   // clear interrupt flags
+  if(SPI_DMA_callback) SPI_DMA_callback();        // call user function
+}
+
+#endif  // SPI_DMA > 0
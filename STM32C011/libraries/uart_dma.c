@@ -1,5 +1,5 @@
 // ===================================================================================
-// USART1 with DMA RX Buffer for STM32C0xx                                    * v1.0 *
+// USART1 with DMA RX Buffer for STM32C0xx                                    * v1.1 *
 // ===================================================================================
 // 2023 by Stefan Wagner:   https://github.com/wagiminator
 
@@ -81,3 +81,18 @@ void UART_write(const char c) {
   while(!UART_ready());
   USART1->TDR = c;
 }
+
+// Get pointer to longest contiguous readable span in RX buffer, return its length
+uint16_t UART_peek(const char** ptr) {
+  uint16_t hptr = UART_RX_hptr;
+  *ptr = UART_RX_buffer + UART_RX_tptr;
+  if(hptr >= UART_RX_tptr) return(hptr - UART_RX_tptr);
+  return(UART_RX_BUF_SIZE - UART_RX_tptr);
+}
+
+// Remove n bytes from RX buffer
+void UART_consume(uint16_t n) {
+  n += UART_RX_tptr;
+  if(n >= UART_RX_BUF_SIZE) n -= UART_RX_BUF_SIZE;
+  UART_RX_tptr = n;
+}
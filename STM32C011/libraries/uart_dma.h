@@ -1,5 +1,5 @@
 // ===================================================================================
-// USART1 with DMA RX Buffer for STM32C0xx                                    * v1.0 *
+// USART1 with DMA RX Buffer for STM32C0xx                                    * v1.1 *
 // ===================================================================================
 //
 // Functions available:
@@ -17,6 +17,8 @@
 // UART_completed()         Check if transmission is completed
 //
 // UART_read()              Read character via UART
+// UART_peek(&p)            Get pointer (p) to contiguous received data, returns length
+// UART_consume(n)          Remove n bytes from RX buffer (after UART_peek)
 // UART_write(c)            Send character via UART
 //
 // UART_enable()            Enable USART
@@ -95,6 +97,8 @@ void UART_init(void);                     // init UART with default BAUD rate
 char UART_read(void);                     // read character via UART
 void UART_write(const char c);            // send character via UART
 uint8_t UART_available(void);             // check if there is something to read
+uint16_t UART_peek(const char** ptr);     // get contiguous readable span
+void UART_consume(uint16_t n);            // remove n bytes from RX buffer
 
 // Additional print functions (if activated, see above)
 #if UART_PRINT == 1
@@ -1,5 +1,5 @@
 // ===================================================================================
-// USART1 with DMA RX Buffer (RX only) for STM32C0xx                          * v1.0 *
+// USART1 with DMA RX Buffer (RX only) for STM32C0xx                          * v1.1 *
 // ===================================================================================
 //
 // Functions available:
@@ -14,6 +14,8 @@
 //
 // UART_available()         Check if there is something to read
 // UART_read()              Read character via UART
+// UART_peek(&p)            Get pointer (p) to contiguous received data, returns length
+// UART_consume(n)          Remove n bytes from RX buffer (after UART_peek)
 //
 // UART_enable()            Enable USART
 // UART_disable()           Disable USART
@@ -73,6 +75,8 @@ extern "C" {
 void UART_init(void);                     // init UART with default BAUD rate
 char UART_read(void);                     // read character via UART
 uint8_t UART_available(void);             // check if there is something to read
+uint16_t UART_peek(const char** ptr);     // get contiguous readable span
+void UART_consume(uint16_t n);            // remove n bytes from RX buffer
 
 // DMA channel defines
 #if   UART_DMA_CHANNEL == 1
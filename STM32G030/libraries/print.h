@@ -1,10 +1,14 @@
 // ===================================================================================
-// Basic PRINT Functions                                                      * v1.1 *
+// Basic PRINT Functions                                                      * v1.2 *
 // ===================================================================================
 //
 // Functions available:
 // --------------------
 // printF(putchar, f, ...)  Uses printf (supports %s, %c, %d, %u, %x, %b, %02d, %%)
+// printFB(write, f, ...)   Uses printf, but formats into the staging buffer first and
+//                          hands it as a block to write(buf, len) (e.g. DMA, USB)
+// sprintF(b, n, f, ...)    Uses printf to format into buffer b of size n (incl. '\0'),
+//                          returns number of characters written
 // printD(putchar, n)       Print decimal value as string via putchar function
 // printW(putchar, n)       Print 32-bit hex word value as string via putchar function
 // printH(putchar, n)       Print 16-bit hex half-word value as string via putchar function
@@ -22,6 +26,9 @@ extern "C" {
 
 #include <stdint.h>
 
+// PRINT Parameters
+#define PRINT_BUF_SIZE    64        // size of staging buffer for printFB
+
 void printD(void (*putchar) (char c), uint32_t value);
 void printB(void (*putchar) (char c), uint8_t value);
 void printH(void (*putchar) (char c), uint16_t value);
@@ -29,6 +36,8 @@ void printW(void (*putchar) (char c), uint32_t value);
 void printS(void (*putchar) (char c), const char* str);
 void println(void (*putchar) (char c), const char* str);
 void printF(void (*putchar) (char c), const char *format, ...);
+void printFB(void (*write) (const char* buf, uint16_t len), const char *format, ...);
+uint16_t sprintF(char* buf, uint16_t size, const char *format, ...);
 
 #ifdef __cplusplus
 };